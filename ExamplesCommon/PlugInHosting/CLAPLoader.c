@@ -28,8 +28,12 @@
     #include <conio.h>
 #elif defined(__APPLE__)
     #include <CoreFoundation/CoreFoundation.h>
+    #include <pthread.h>
+    #include <unistd.h>
 #elif defined(__linux__)
     #include <dlfcn.h>
+    #include <pthread.h>
+    #include <unistd.h>
 #endif
 
 #include <math.h>
@@ -57,10 +61,45 @@ struct _CLAPBinary
     const clap_plugin_entry_t * entry;
 };
 
+// Host side of the CLAP thread pool extension: while the plug-in is rendering, a set of worker threads
+// waits for the plug-in to request the execution of tasks. The render thread processes tasks too,
+// then blocks until all tasks are done. The tasks are distributed under a mutex, which is acceptable
+// for this test code, but actual hosts will want to integrate this with their own realtime scheduling.
+#define CLAP_HOST_THREAD_POOL_MAX_THREAD_COUNT 15
+
+#if defined(_WIN32)
+    typedef HANDLE CLAPThread;
+    typedef SRWLOCK CLAPMutex;
+    typedef CONDITION_VARIABLE CLAPCondition;
+#else
+    typedef pthread_t CLAPThread;
+    typedef pthread_mutex_t CLAPMutex;
+    typedef pthread_cond_t CLAPCondition;
+#endif
+
+typedef struct _CLAPHostThreadPool
+{
+    const clap_plugin_t * plugin;
+    const clap_plugin_thread_pool_t * pluginThreadPool;
+    uint32_t threadCount;
+    CLAPThread threads[CLAP_HOST_THREAD_POOL_MAX_THREAD_COUNT];
+
+    // all below guarded by mutex
+    CLAPMutex mutex;
+    CLAPCondition condition;
+    uint32_t taskCount;
+    uint32_t nextTaskIndex;
+    uint32_t pendingTaskCount;
+    bool shouldStop;
+} CLAPHostThreadPool;
+
 struct _CLAPPlugIn
 {
     const clap_plugin_t * plugin;
     double sampleRate;
+    bool supports64BitSamples;          // only valid while rendering
+    clap_host_t host;
+    CLAPHostThreadPool * threadPool;    // only valid while rendering
 };
 
 
@@ -186,8 +225,174 @@ const ARAFactory * CLAPGetARAFactory(CLAPBinary clapBinary, const char * optiona
     }
 }
 
-const void * host_get_extension(const clap_host_t * ARA_MAYBE_UNUSED_ARG(host), const char * ARA_MAYBE_UNUSED_ARG(extension_id))
+static void thread_pool_lock(CLAPHostThreadPool * threadPool)
+{
+#if defined(_WIN32)
+    AcquireSRWLockExclusive(&threadPool->mutex);
+#else
+    pthread_mutex_lock(&threadPool->mutex);
+#endif
+}
+
+static void thread_pool_unlock(CLAPHostThreadPool * threadPool)
+{
+#if defined(_WIN32)
+    ReleaseSRWLockExclusive(&threadPool->mutex);
+#else
+    pthread_mutex_unlock(&threadPool->mutex);
+#endif
+}
+
+static void thread_pool_wait(CLAPHostThreadPool * threadPool)
+{
+#if defined(_WIN32)
+    SleepConditionVariableSRW(&threadPool->condition, &threadPool->mutex, INFINITE, 0);
+#else
+    pthread_cond_wait(&threadPool->condition, &threadPool->mutex);
+#endif
+}
+
+static void thread_pool_notify(CLAPHostThreadPool * threadPool)
 {
+#if defined(_WIN32)
+    WakeAllConditionVariable(&threadPool->condition);
+#else
+    pthread_cond_broadcast(&threadPool->condition);
+#endif
+}
+
+// must be called with the mutex locked, returns with the mutex locked
+static void thread_pool_execute_pending_tasks(CLAPHostThreadPool * threadPool)
+{
+    while (threadPool->nextTaskIndex < threadPool->taskCount)
+    {
+        const uint32_t taskIndex = threadPool->nextTaskIndex++;
+        thread_pool_unlock(threadPool);
+        threadPool->pluginThreadPool->exec(threadPool->plugin, taskIndex);
+        thread_pool_lock(threadPool);
+        if (--threadPool->pendingTaskCount == 0)
+            thread_pool_notify(threadPool);
+    }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI thread_pool_worker(LPVOID context)
+#else
+static void * thread_pool_worker(void * context)
+#endif
+{
+    CLAPHostThreadPool * threadPool = (CLAPHostThreadPool *)context;
+    thread_pool_lock(threadPool);
+    while (!threadPool->shouldStop)
+    {
+        if (threadPool->nextTaskIndex < threadPool->taskCount)
+            thread_pool_execute_pending_tasks(threadPool);
+        else
+            thread_pool_wait(threadPool);
+    }
+    thread_pool_unlock(threadPool);
+    return 0;
+}
+
+static CLAPHostThreadPool * thread_pool_create(const clap_plugin_t * plugin, const clap_plugin_thread_pool_t * pluginThreadPool)
+{
+    CLAPHostThreadPool * threadPool = malloc(sizeof(CLAPHostThreadPool));
+    ARA_INTERNAL_ASSERT(threadPool);
+    threadPool->plugin = plugin;
+    threadPool->pluginThreadPool = pluginThreadPool;
+    threadPool->taskCount = 0;
+    threadPool->nextTaskIndex = 0;
+    threadPool->pendingTaskCount = 0;
+    threadPool->shouldStop = false;
+
+    // use one thread per additional core, the render thread also executes tasks
+#if defined(_WIN32)
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    const long coreCount = (long)systemInfo.dwNumberOfProcessors;
+    InitializeSRWLock(&threadPool->mutex);
+    InitializeConditionVariable(&threadPool->condition);
+#else
+    const long coreCount = sysconf(_SC_NPROCESSORS_ONLN);
+    pthread_mutex_init(&threadPool->mutex, NULL);
+    pthread_cond_init(&threadPool->condition, NULL);
+#endif
+    threadPool->threadCount = (coreCount > 1) ? (uint32_t)(coreCount - 1) : 0;
+    if (threadPool->threadCount > CLAP_HOST_THREAD_POOL_MAX_THREAD_COUNT)
+        threadPool->threadCount = CLAP_HOST_THREAD_POOL_MAX_THREAD_COUNT;
+
+    for (uint32_t i = 0; i < threadPool->threadCount; ++i)
+    {
+#if defined(_WIN32)
+        threadPool->threads[i] = CreateThread(NULL, 0, thread_pool_worker, threadPool, 0, NULL);
+        ARA_INTERNAL_ASSERT(threadPool->threads[i] != NULL);
+#else
+        int ARA_MAYBE_UNUSED_VAR(result);
+        result = pthread_create(&threadPool->threads[i], NULL, thread_pool_worker, threadPool);
+        ARA_INTERNAL_ASSERT(result == 0);
+#endif
+    }
+    return threadPool;
+}
+
+static void thread_pool_destroy(CLAPHostThreadPool * threadPool)
+{
+    thread_pool_lock(threadPool);
+    threadPool->shouldStop = true;
+    thread_pool_notify(threadPool);
+    thread_pool_unlock(threadPool);
+
+    for (uint32_t i = 0; i < threadPool->threadCount; ++i)
+    {
+#if defined(_WIN32)
+        WaitForSingleObject(threadPool->threads[i], INFINITE);
+        CloseHandle(threadPool->threads[i]);
+#else
+        pthread_join(threadPool->threads[i], NULL);
+#endif
+    }
+
+#if !defined(_WIN32)
+    pthread_cond_destroy(&threadPool->condition);
+    pthread_mutex_destroy(&threadPool->mutex);
+#endif
+    free(threadPool);
+}
+
+static bool CLAP_ABI host_thread_pool_request_exec(const clap_host_t * host, uint32_t num_tasks)
+{
+    CLAPPlugIn clapPlugIn = (CLAPPlugIn)host->host_data;
+    CLAPHostThreadPool * threadPool = clapPlugIn->threadPool;
+    if (threadPool == NULL)
+        return false;
+
+    thread_pool_lock(threadPool);
+    ARA_INTERNAL_ASSERT(threadPool->pendingTaskCount == 0);     // request_exec() must not be called concurrently
+    threadPool->taskCount = num_tasks;
+    threadPool->nextTaskIndex = 0;
+    threadPool->pendingTaskCount = num_tasks;
+    thread_pool_notify(threadPool);
+
+    // help executing the tasks, then wait until the worker threads are done too
+    thread_pool_execute_pending_tasks(threadPool);
+    while (threadPool->pendingTaskCount > 0)
+        thread_pool_wait(threadPool);
+
+    threadPool->taskCount = 0;
+    threadPool->nextTaskIndex = 0;
+    thread_pool_unlock(threadPool);
+    return true;
+}
+
+static const clap_host_thread_pool_t clap_host_thread_pool =
+{
+    .request_exec = host_thread_pool_request_exec
+};
+
+const void * host_get_extension(const clap_host_t * ARA_MAYBE_UNUSED_ARG(host), const char * extension_id)
+{
+    if (strcmp(extension_id, CLAP_EXT_THREAD_POOL) == 0)
+        return &clap_host_thread_pool;
     return NULL;
 }
 
@@ -197,7 +402,7 @@ void host_request_dummy(const clap_host_t * ARA_MAYBE_UNUSED_ARG(host))
 
 #define _IN_QUOTES_HELPER(x) #x
 #define IN_QUOTES(x) _IN_QUOTES_HELPER(x)
-static const clap_host_t clap_host =
+static const clap_host_t clap_host_template =
 {
     .clap_version = CLAP_VERSION_INIT,
     .host_data = NULL,
@@ -243,9 +448,14 @@ CLAPPlugIn CLAPCreatePlugIn(CLAPBinary clapBinary, const char* optionalPlugInNam
         ARA_INTERNAL_ASSERT(desc != NULL);
     }
 
+    // each plug-in instance gets its own host struct, so that host callbacks can access the instance
     CLAPPlugIn clapPlugIn = malloc(sizeof(struct _CLAPPlugIn));
     ARA_INTERNAL_ASSERT(clapPlugIn);
-    clapPlugIn->plugin = factory->create_plugin(factory, &clap_host, desc->id);
+    clapPlugIn->supports64BitSamples = false;
+    clapPlugIn->threadPool = NULL;
+    clapPlugIn->host = clap_host_template;
+    clapPlugIn->host.host_data = clapPlugIn;
+    clapPlugIn->plugin = factory->create_plugin(factory, &clapPlugIn->host, desc->id);
     clapPlugIn->plugin->init(clapPlugIn->plugin);
     return clapPlugIn;
 }
@@ -324,6 +534,14 @@ void CLAPStartRendering(CLAPPlugIn clapPlugIn, uint32_t maxBlockSize, double sam
     ARA_INTERNAL_ASSERT(out_info.channel_count == 1);
 
     clapPlugIn->sampleRate = sampleRate;
+    // the port info may only be queried on the main thread, so the 64 bit capability is cached here
+    clapPlugIn->supports64BitSamples = ((in_info.flags & CLAP_AUDIO_PORT_SUPPORTS_64BITS) != 0) &&
+                                       ((out_info.flags & CLAP_AUDIO_PORT_SUPPORTS_64BITS) != 0);
+
+    // provide a thread pool if the plug-in supports it
+    const clap_plugin_thread_pool_t * plugin_thread_pool = clapPlugIn->plugin->get_extension(clapPlugIn->plugin, CLAP_EXT_THREAD_POOL);
+    if (plugin_thread_pool && plugin_thread_pool->exec)
+        clapPlugIn->threadPool = thread_pool_create(clapPlugIn->plugin, plugin_thread_pool);
 
     clapPlugIn->plugin->activate(clapPlugIn->plugin, sampleRate, 1, maxBlockSize);
     clapPlugIn->plugin->start_processing(clapPlugIn->plugin);
@@ -344,7 +562,7 @@ bool CLAP_ABI output_events_try_push(const struct clap_output_events* list, cons
   return false;
 }
 
-void CLAPRenderBuffer(CLAPPlugIn clapPlugIn, uint32_t blockSize, int64_t samplePosition, float * buffer)
+static void render_buffer(CLAPPlugIn clapPlugIn, uint32_t blockSize, int64_t samplePosition, float ** data32, double ** data64)
 {
     ARA_INTERNAL_ASSERT(blockSize >= 1);
 
@@ -380,7 +598,8 @@ void CLAPRenderBuffer(CLAPPlugIn clapPlugIn, uint32_t blockSize, int64_t sampleP
     // I/O
     const clap_audio_buffer_t audio_inputs =
     {
-        .data32 = &buffer,
+        .data32 = data32,
+        .data64 = data64,
         .channel_count = 1,
         .latency = 0,
         .constant_mask = UINT64_MAX
@@ -388,14 +607,13 @@ void CLAPRenderBuffer(CLAPPlugIn clapPlugIn, uint32_t blockSize, int64_t sampleP
 
     clap_audio_buffer_t audio_outputs =
     {
-        .data32 = &buffer,
+        .data32 = data32,
+        .data64 = data64,
         .channel_count = 1,
         .latency = 0,
         .constant_mask = 0
     };
 
-    memset(buffer, 0, blockSize * sizeof(float));
-
     // process
     clap_process_t process =
     {
@@ -415,10 +633,35 @@ void CLAPRenderBuffer(CLAPPlugIn clapPlugIn, uint32_t blockSize, int64_t sampleP
     ARA_INTERNAL_ASSERT(status != CLAP_PROCESS_ERROR);
 }
 
+void CLAPRenderBuffer(CLAPPlugIn clapPlugIn, uint32_t blockSize, int64_t samplePosition, float * buffer)
+{
+    memset(buffer, 0, blockSize * sizeof(float));
+    render_buffer(clapPlugIn, blockSize, samplePosition, &buffer, NULL);
+}
+
+bool CLAPSupports64BitSamples(CLAPPlugIn clapPlugIn)
+{
+    return clapPlugIn->supports64BitSamples;
+}
+
+void CLAPRenderBuffer64(CLAPPlugIn clapPlugIn, uint32_t blockSize, int64_t samplePosition, double * buffer)
+{
+    ARA_INTERNAL_ASSERT(clapPlugIn->supports64BitSamples);
+
+    memset(buffer, 0, blockSize * sizeof(double));
+    render_buffer(clapPlugIn, blockSize, samplePosition, NULL, &buffer);
+}
+
 void CLAPStopRendering(CLAPPlugIn clapPlugIn)
 {
     clapPlugIn->plugin->stop_processing(clapPlugIn->plugin);
     clapPlugIn->plugin->deactivate(clapPlugIn->plugin);
+
+    if (clapPlugIn->threadPool)
+    {
+        thread_pool_destroy(clapPlugIn->threadPool);
+        clapPlugIn->threadPool = NULL;
+    }
 }
 
 void CLAPDestroyPlugIn(CLAPPlugIn clapPlugIn)
@@ -38,6 +38,10 @@ CLAPPlugIn CLAPCreatePlugIn(CLAPBinary clapBinary, const char * optionalPlugInNa
 const ARA_NAMESPACE ARAPlugInExtensionInstance * CLAPBindToARADocumentController(CLAPPlugIn clapPlugIn, ARA_NAMESPACE ARADocumentControllerRef controllerRef, ARA_NAMESPACE ARAPlugInInstanceRoleFlags assignedRoles);
 void CLAPStartRendering(CLAPPlugIn clapPlugIn, uint32_t maxBlockSize, double sampleRate);
 void CLAPRenderBuffer(CLAPPlugIn clapPlugIn, uint32_t blockSize, int64_t samplePosition, float * buffer);
+// rendering with 64 bit samples is optional - CLAPSupports64BitSamples() is valid after CLAPStartRendering(),
+// and CLAPRenderBuffer64() may only be used if it returns true
+bool CLAPSupports64BitSamples(CLAPPlugIn clapPlugIn);
+void CLAPRenderBuffer64(CLAPPlugIn clapPlugIn, uint32_t blockSize, int64_t samplePosition, double * buffer);
 void CLAPStopRendering(CLAPPlugIn clapPlugIn);
 void CLAPDestroyPlugIn(CLAPPlugIn clapPlugIn);
 void CLAPUnloadBinary(CLAPBinary clapBinary);
@@ -36,6 +36,8 @@
 #include "ARA_Library/IPC/ARAIPCProxyPlugIn.h"
 
 #include <thread>
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstring>
 
@@ -124,14 +126,14 @@ void ARADocumentController::addMusicalContext (MusicalContext* musicalContext)
 {
     ARA_INTERNAL_ASSERT (_isEditingDocument);
     const auto musicalContextProperties { getMusicalContextProperties (musicalContext) };
-    _musicalContextRefs[musicalContext] = _documentController->createMusicalContext (toHostRef (musicalContext), &musicalContextProperties);
+    musicalContext->setPlugInRef (_documentController->createMusicalContext (toHostRef (musicalContext), &musicalContextProperties));
 }
 
 void ARADocumentController::removeMusicalContext (MusicalContext* musicalContext)
 {
     ARA_INTERNAL_ASSERT (_isEditingDocument);
     _documentController->destroyMusicalContext (getRef (musicalContext));
-    _musicalContextRefs.erase (musicalContext);
+    musicalContext->setPlugInRef (nullptr);
 }
 
 void ARADocumentController::updateMusicalContextProperties (MusicalContext* musicalContext)
@@ -163,14 +165,14 @@ void ARADocumentController::addRegionSequence (RegionSequence* regionSequence)
 {
     ARA_INTERNAL_ASSERT (_isEditingDocument);
     const auto regionSequenceProperties { getRegionSequenceProperties (regionSequence) };
-    _regionSequenceRefs[regionSequence] = _documentController->createRegionSequence (toHostRef (regionSequence), &regionSequenceProperties);
+    regionSequence->setPlugInRef (_documentController->createRegionSequence (toHostRef (regionSequence), &regionSequenceProperties));
 }
 
 void ARADocumentController::removeRegionSequence (RegionSequence* regionSequence)
 {
     ARA_INTERNAL_ASSERT (_isEditingDocument);
     _documentController->destroyRegionSequence (getRef (regionSequence));
-    _regionSequenceRefs.erase (regionSequence);
+    regionSequence->setPlugInRef (nullptr);
 }
 
 void ARADocumentController::updateRegionSequenceProperties (RegionSequence* regionSequence)
@@ -200,14 +202,14 @@ void ARADocumentController::addAudioSource (AudioSource* audioSource)
 {
     ARA_INTERNAL_ASSERT (_isEditingDocument);
     const auto audioSourceProperties { getAudioSourceProperties (audioSource) };
-    _audioSourceRefs[audioSource] = _documentController->createAudioSource (toHostRef (audioSource), &audioSourceProperties);
+    audioSource->setPlugInRef (_documentController->createAudioSource (toHostRef (audioSource), &audioSourceProperties));
 }
 
 void ARADocumentController::removeAudioSource (AudioSource* audioSource)
 {
     ARA_INTERNAL_ASSERT (_isEditingDocument);
     _documentController->destroyAudioSource (getRef (audioSource));
-    _audioSourceRefs.erase (audioSource);
+    audioSource->setPlugInRef (nullptr);
 }
 
 void ARADocumentController::updateAudioSourceProperties (AudioSource* audioSource)
@@ -237,21 +239,21 @@ void ARADocumentController::addAudioModification (AudioModification* audioModifi
 {
     ARA_INTERNAL_ASSERT (_isEditingDocument);
     const auto audioModificationProperties { getAudioModificationProperties (audioModification) };
-    _audioModificationRefs[audioModification] = _documentController->createAudioModification (getRef (audioModification->getAudioSource ()), toHostRef (audioModification), &audioModificationProperties);
+    audioModification->setPlugInRef (_documentController->createAudioModification (getRef (audioModification->getAudioSource ()), toHostRef (audioModification), &audioModificationProperties));
 }
 
 void ARADocumentController::cloneAudioModification (AudioModification* sourceAudioModification, AudioModification* clonedAudioModification)
 {
     ARA_INTERNAL_ASSERT (_isEditingDocument);
     const auto cloneProperties { getAudioModificationProperties (clonedAudioModification) };
-    _audioModificationRefs[clonedAudioModification] = _documentController->cloneAudioModification (getRef (sourceAudioModification), toHostRef (clonedAudioModification), &cloneProperties);
+    clonedAudioModification->setPlugInRef (_documentController->cloneAudioModification (getRef (sourceAudioModification), toHostRef (clonedAudioModification), &cloneProperties));
 }
 
 void ARADocumentController::removeAudioModification (AudioModification* audioModification)
 {
     ARA_INTERNAL_ASSERT (_isEditingDocument);
     _documentController->destroyAudioModification (getRef (audioModification));
-    _audioModificationRefs.erase (audioModification);
+    audioModification->setPlugInRef (nullptr);
 }
 
 void ARADocumentController::updateAudioModificationProperties (AudioModification* audioModification)
@@ -282,14 +284,14 @@ void ARADocumentController::addPlaybackRegion (PlaybackRegion* playbackRegion)
 {
     ARA_INTERNAL_ASSERT (_isEditingDocument);
     const auto playbackRegionProperties { getPlaybackRegionProperties (playbackRegion) };
-    _playbackRegionRefs[playbackRegion] = _documentController->createPlaybackRegion (getRef (playbackRegion->getAudioModification ()), toHostRef (playbackRegion), &playbackRegionProperties);
+    playbackRegion->setPlugInRef (_documentController->createPlaybackRegion (getRef (playbackRegion->getAudioModification ()), toHostRef (playbackRegion), &playbackRegionProperties));
 }
 
 void ARADocumentController::removePlaybackRegion (PlaybackRegion* playbackRegion)
 {
     ARA_INTERNAL_ASSERT (_isEditingDocument);
     _documentController->destroyPlaybackRegion (getRef (playbackRegion));
-    _playbackRegionRefs.erase (playbackRegion);
+    playbackRegion->setPlugInRef (nullptr);
 }
 
 void ARADocumentController::updatePlaybackRegionProperties (PlaybackRegion* playbackRegion)
@@ -381,7 +383,7 @@ void ARADocumentController::getPlaybackRegionHeadAndTailTime (PlaybackRegion* pl
     _documentController->getPlaybackRegionHeadAndTailTime (getRef (playbackRegion), headTime, tailTime);
 }
 
-void ARADocumentController::requestAudioSourceContentAnalysis (AudioSource* audioSource, size_t contentTypesCount, const ARA::ARAContentType contentTypes[], std::function<void (void)>* waitFunction)
+bool ARADocumentController::isLicensedForContentAnalysis (size_t contentTypesCount, const ARA::ARAContentType contentTypes[])
 {
     // check license first without opening UI
     auto isLicensed { _documentController->isLicensedForCapabilities (false, contentTypesCount, contentTypes, ARA::kARAPlaybackTransformationNoChanges) };
@@ -413,17 +415,52 @@ void ARADocumentController::requestAudioSourceContentAnalysis (AudioSource* audi
             isLicensed = _documentController->isLicensedForCapabilities (true, contentTypesCount, contentTypes, ARA::kARAPlaybackTransformationNoChanges);
     }
 
-    if (!isLicensed)
+    return isLicensed;
+}
+
+void ARADocumentController::requestAudioSourceContentAnalysis (AudioSource* audioSource, size_t contentTypesCount, const ARA::ARAContentType contentTypes[], std::function<void (int32_t)>* waitFunction)
+{
+    if (!isLicensedForContentAnalysis (contentTypesCount, contentTypes))
         return;
 
     _documentController->requestAudioSourceContentAnalysis (getRef (audioSource), contentTypesCount, contentTypes);
 
+    if (waitFunction != nullptr)
+        waitForAudioSourcesContentAnalysis ({ audioSource }, contentTypesCount, contentTypes, *waitFunction);
+}
+
+void ARADocumentController::requestAudioSourcesContentAnalysis (const std::vector<AudioSource*>& audioSources, size_t contentTypesCount, const ARA::ARAContentType contentTypes[], std::function<void (int32_t)>* waitFunction)
+{
+    if (!isLicensedForContentAnalysis (contentTypesCount, contentTypes))
+        return;
+
+    for (const auto& audioSource : audioSources)
+        _documentController->requestAudioSourceContentAnalysis (getRef (audioSource), contentTypesCount, contentTypes);
+
     if (waitFunction == nullptr)
         return;
 
+    const auto completionDurations { waitForAudioSourcesContentAnalysis (audioSources, contentTypesCount, contentTypes, *waitFunction) };
+    for (auto i { 0U }; i < audioSources.size (); ++i)
+        ARA_LOG ("audio source %p (ARAAudioSourceRef %p) analysis completed after %.3f seconds", audioSources[i], getRef (audioSources[i]), completionDurations[i]);
+    ARA_LOG ("analysis of %i audio sources completed after %.3f seconds", static_cast<int> (audioSources.size ()),
+                (completionDurations.empty ()) ? 0.0 : *std::max_element (completionDurations.begin (), completionDurations.end ()));
+}
+
+std::vector<double> ARADocumentController::waitForAudioSourcesContentAnalysis (const std::vector<AudioSource*>& audioSources, size_t contentTypesCount, const ARA::ARAContentType contentTypes[], std::function<void (int32_t)>& waitFunction)
+{
     // Now we've got to wait for analysis to complete -
     // normally this would be done asynchronously, but in this simple test code we'll just
-    // spin in a crude "update loop" until our requested analysis is complete
+    // spin in a crude "update loop" until our requested analysis is complete.
+    // ARA does not provide a way for the plug-in to wake up the host when analysis completes,
+    // the host learns about it only when calling notifyModelUpdates (). To keep the latency
+    // low without polling all the time, we use the progress reported by the plug-in to estimate
+    // the remaining time, and suggest to wait half of it before polling again, so that the
+    // intervals shrink towards the (estimated) end of the analysis.
+    constexpr int32_t minWaitDuration { 1 };
+    constexpr int32_t maxWaitDuration { 50 };
+    const auto startTime { std::chrono::steady_clock::now () };
+    std::vector<double> completionDurations (audioSources.size (), -1.0);
     while (true)
     {
         // Because this is our update loop, query the document controller for model updates here
@@ -431,20 +468,42 @@ void ARADocumentController::requestAudioSourceContentAnalysis (AudioSource* audi
         _documentController->notifyModelUpdates ();
         _isPollingModelUpdates = false;
 
-        // Check if all analysis is done for the available analysis content types
+        const auto elapsedDuration { std::chrono::duration<double> (std::chrono::steady_clock::now () - startTime).count () };
         bool allDone { true };
-        for (auto t { 0U }; t < contentTypesCount; ++t)
+        auto waitDuration { maxWaitDuration };
+        for (auto i { 0U }; i < audioSources.size (); ++i)
         {
-            if (_documentController->isAudioSourceContentAnalysisIncomplete (getRef (audioSource), contentTypes[t]))
+            if (completionDurations[i] >= 0.0)
+                continue;
+
+            // Check if all analysis is done for the available analysis content types
+            bool isDone { true };
+            for (auto t { 0U }; t < contentTypesCount; ++t)
+            {
+                if (_documentController->isAudioSourceContentAnalysisIncomplete (getRef (audioSources[i]), contentTypes[t]))
+                {
+                    isDone = false;
+                    break;
+                }
+            }
+            if (isDone)
+            {
+                completionDurations[i] = elapsedDuration;
+                continue;
+            }
+            allDone = false;
+
+            const auto progress { getModelUpdateController ()->getAnalysisProgress (audioSources[i]) };
+            if (progress > 0.0f)
             {
-                allDone = false;
-                break;
+                const auto estimatedRemainingDuration { 1000.0 * elapsedDuration * (1.0 - progress) / progress };
+                waitDuration = std::min (waitDuration, static_cast<int32_t> (std::max (static_cast<double> (minWaitDuration), std::min (0.5 * estimatedRemainingDuration, static_cast<double> (maxWaitDuration)))));
             }
         }
         if (allDone)
-            return;
+            return completionDurations;
 
-        (*waitFunction) ();
+        waitFunction (waitDuration);
     }
 }
 
@@ -36,6 +36,7 @@
 #include <functional>
 #include <map>
 #include <thread>
+#include <vector>
 
 // These macros allow us to use pointers to host side model objects as
 // ARA host reference types that will be passed to the ARA APIs
@@ -135,8 +136,12 @@ public:
     /*******************************************************************************/
     // Functions to trigger audio source analysis and deal with processing algorithm selection
 
-    // if a waitFunction is provided, requestAudioSourceContentAnalysis() will wait by repeatedly calling this function until analysis has completed
-    void requestAudioSourceContentAnalysis (AudioSource* audioSource, size_t contentTypesCount, const ARA::ARAContentType contentTypes[], std::function<void (void)>* waitFunction);
+    // if a waitFunction is provided, requestAudioSourceContentAnalysis() will wait by repeatedly calling this function until analysis has completed,
+    // passing a suggested wait duration in milliseconds which is estimated from the analysis progress reported by the plug-in
+    void requestAudioSourceContentAnalysis (AudioSource* audioSource, size_t contentTypesCount, const ARA::ARAContentType contentTypes[], std::function<void (int32_t)>* waitFunction);
+    // requests analysis for all given audio sources at once so that the plug-in can analyze them concurrently,
+    // and if a waitFunction is provided, waits until all of them have completed and logs the timings
+    void requestAudioSourcesContentAnalysis (const std::vector<AudioSource*>& audioSources, size_t contentTypesCount, const ARA::ARAContentType contentTypes[], std::function<void (int32_t)>* waitFunction);
 
     int getProcessingAlgorithmsCount ();
     const ARA::ARAProcessingAlgorithmProperties* getProcessingAlgorithmProperties (int algorithmIndex);
@@ -168,11 +173,11 @@ public:
 
     // If the host and plug-in documents are in sync then each document object
     // will have a reference to its plug-in side representation, accessible here
-    ARA::ARAMusicalContextRef getRef (MusicalContext* musicalContext) const noexcept { return _musicalContextRefs.at (musicalContext); }
-    ARA::ARARegionSequenceRef getRef (RegionSequence* regionSequence) const noexcept { return _regionSequenceRefs.at (regionSequence); }
-    ARA::ARAAudioSourceRef getRef (AudioSource* audioSource) const noexcept { return _audioSourceRefs.at (audioSource); }
-    ARA::ARAAudioModificationRef getRef (AudioModification* audioModification) const noexcept { return _audioModificationRefs.at (audioModification); }
-    ARA::ARAPlaybackRegionRef getRef (PlaybackRegion* playbackRegion) const noexcept { return _playbackRegionRefs.at (playbackRegion); }
+    ARA::ARAMusicalContextRef getRef (MusicalContext* musicalContext) const noexcept { return getValidatedRef (musicalContext); }
+    ARA::ARARegionSequenceRef getRef (RegionSequence* regionSequence) const noexcept { return getValidatedRef (regionSequence); }
+    ARA::ARAAudioSourceRef getRef (AudioSource* audioSource) const noexcept { return getValidatedRef (audioSource); }
+    ARA::ARAAudioModificationRef getRef (AudioModification* audioModification) const noexcept { return getValidatedRef (audioModification); }
+    ARA::ARAPlaybackRegionRef getRef (PlaybackRegion* playbackRegion) const noexcept { return getValidatedRef (playbackRegion); }
 
 #if ARA_VALIDATE_API_CALLS
     bool isUsingArchive (const ArchiveBase* archive = nullptr);
@@ -181,6 +186,13 @@ public:
 #endif
 
 private:
+    template <typename ModelObjectType>
+    static auto getValidatedRef (const ModelObjectType* modelObject) noexcept -> decltype (modelObject->getPlugInRef ())
+    {
+        ARA_INTERNAL_ASSERT (modelObject->getPlugInRef () != nullptr);
+        return modelObject->getPlugInRef ();
+    }
+
     const DocumentProperties getDocumentProperties () const noexcept;
     const MusicalContextProperties getMusicalContextProperties (const MusicalContext* musicalContext) const noexcept;
     const RegionSequenceProperties getRegionSequenceProperties (const RegionSequence* regionSequence) const noexcept;
@@ -188,6 +200,10 @@ private:
     const AudioModificationProperties getAudioModificationProperties (const AudioModification* audioModification) const noexcept;
     const PlaybackRegionProperties getPlaybackRegionProperties (const PlaybackRegion* playbackRegion) const noexcept;
 
+    bool isLicensedForContentAnalysis (size_t contentTypesCount, const ARA::ARAContentType contentTypes[]);
+    // returns the time from the start of waiting until each of the audio sources completed its analysis, in seconds
+    std::vector<double> waitForAudioSourcesContentAnalysis (const std::vector<AudioSource*>& audioSources, size_t contentTypesCount, const ARA::ARAContentType contentTypes[], std::function<void (int32_t)>& waitFunction);
+
     ARAAudioAccessController* getAudioAccessController () const noexcept;
     ARAArchivingController* getArchivingController () const noexcept;
     ARAContentAccessController* getContentAccessController () const noexcept;
@@ -200,13 +216,6 @@ private:
     ARA::Host::DocumentControllerHostInstance _documentControllerHostInstance;
     std::unique_ptr<ARA::Host::DocumentController> _documentController;
 
-    // These maps are used to associate objects in our document with their plug-in side counterparts
-    std::map<MusicalContext*, ARA::ARAMusicalContextRef> _musicalContextRefs;
-    std::map<RegionSequence*, ARA::ARARegionSequenceRef> _regionSequenceRefs;
-    std::map<AudioSource*, ARA::ARAAudioSourceRef> _audioSourceRefs;
-    std::map<AudioModification*, ARA::ARAAudioModificationRef> _audioModificationRefs;
-    std::map<PlaybackRegion*, ARA::ARAPlaybackRegionRef> _playbackRegionRefs;
-
     // for debugging only, see isUsingArchive ()
     const ArchiveBase* _currentArchive { nullptr };
 
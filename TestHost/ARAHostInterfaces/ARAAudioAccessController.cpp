@@ -31,26 +31,46 @@
 
 bool AudioSourceReader::readSamples (ARA::ARASamplePosition samplePosition, ARA::ARASampleCount samplesPerChannel, void* const buffers[]) const noexcept
 {
-    return _audioSource->getAudioFile ()->readSamples (samplePosition, samplesPerChannel, buffers, _use64BitSamples);
+    return _audioSource->getBlockCache ().readSamples (samplePosition, samplesPerChannel, buffers, _use64BitSamples);
 }
 
 /*******************************************************************************/
 
 #if ARA_VALIDATE_API_CALLS
-std::mutex _renderThreadMutex;
-std::vector<std::thread::id> _renderThreadIDs;
+// a thread-local flag allows for checking the current thread without any locking
+static thread_local bool _isRenderThread { false };
 
 void ARAAudioAccessController::registerRenderThread ()
 {
-    std::lock_guard<std::mutex> guard (_renderThreadMutex);
-    _renderThreadIDs.push_back (std::this_thread::get_id ());
+    ARA_INTERNAL_ASSERT (!_isRenderThread);
+    _isRenderThread = true;
 }
 
 void ARAAudioAccessController::unregisterRenderThread ()
 {
-    std::lock_guard<std::mutex> guard (_renderThreadMutex);
-    const bool success { ARA::find_erase (_renderThreadIDs, std::this_thread::get_id ()) };
-    ARA_INTERNAL_ASSERT (success);
+    ARA_INTERNAL_ASSERT (_isRenderThread);
+    _isRenderThread = false;
+}
+
+void ARAAudioAccessController::ValidReadersSet::insert (const AudioSourceReader* reader)
+{
+    auto& shard { getShard (reader) };
+    std::lock_guard<std::mutex> guard (shard._mutex);
+    shard._readers.insert (reader);
+}
+
+void ARAAudioAccessController::ValidReadersSet::erase (const AudioSourceReader* reader)
+{
+    auto& shard { getShard (reader) };
+    std::lock_guard<std::mutex> guard (shard._mutex);
+    shard._readers.erase (reader);
+}
+
+bool ARAAudioAccessController::ValidReadersSet::contains (const AudioSourceReader* reader)
+{
+    auto& shard { getShard (reader) };
+    std::lock_guard<std::mutex> guard (shard._mutex);
+    return shard._readers.count (reader) != 0;
 }
 #endif
 
@@ -61,10 +81,10 @@ ARA::ARAAudioReaderHostRef ARAAudioAccessController::createAudioReaderForSource
     const auto audioSource = fromHostRef (audioSourceHostRef);
     ARA_VALIDATE_API_ARGUMENT (audioSourceHostRef, ARA::contains (getDocument ()->getAudioSources (), audioSource));
     ARA_VALIDATE_API_THREAD (_araDocumentController->wasCreatedOnCurrentThread ());
+    _audioSourceReaders.emplace_back (std::make_unique<AudioSourceReader> (audioSource, use64BitSamples));
 #if ARA_VALIDATE_API_CALLS
-    std::lock_guard<std::mutex> guard (_audioSourceReadersMutex);
+    _validAudioSourceReaders.insert (_audioSourceReaders.back ().get ());
 #endif
-    _audioSourceReaders.emplace_back (std::make_unique<AudioSourceReader> (audioSource, use64BitSamples));
     return toHostRef (_audioSourceReaders.back ().get ());
 }
 
@@ -74,19 +94,14 @@ bool ARAAudioAccessController::readAudioSamples (ARA::ARAAudioReaderHostRef audi
 {
     const auto audioSourceReader = fromHostRef (audioReaderHostRef);
 #if ARA_VALIDATE_API_CALLS
-    {
-        std::lock_guard<std::mutex> guard (_renderThreadMutex);
-        ARA_VALIDATE_API_THREAD (!ARA::contains (_renderThreadIDs, std::this_thread::get_id ()));
-    }
-    {
-        std::lock_guard<std::mutex> guard (_audioSourceReadersMutex);
-        ARA_VALIDATE_API_ARGUMENT (audioReaderHostRef, ARA::contains (_audioSourceReaders, audioSourceReader));
-    }
+    ARA_VALIDATE_API_THREAD (!_isRenderThread);
+    ARA_VALIDATE_API_ARGUMENT (audioReaderHostRef, _validAudioSourceReaders.contains (audioSourceReader));
 #endif
     ARA_VALIDATE_API_ARGUMENT (nullptr, samplesPerChannel >= 0);
     ARA_VALIDATE_API_ARGUMENT (buffers, buffers != nullptr);
     for (int i = 0; i < audioSourceReader->getAudioSource ()->getChannelCount (); ++i)
         ARA_VALIDATE_API_ARGUMENT (buffers, buffers[i] != nullptr);
+    _readSampleFrameCount += samplesPerChannel;
     return audioSourceReader->readSamples (samplePosition, samplesPerChannel, buffers);
 }
 
@@ -95,10 +110,10 @@ bool ARAAudioAccessController::readAudioSamples (ARA::ARAAudioReaderHostRef audi
 void ARAAudioAccessController::destroyAudioReader (ARA::ARAAudioReaderHostRef audioReaderHostRef) noexcept
 {
     const auto audioSourceReader = fromHostRef (audioReaderHostRef);
-#if ARA_VALIDATE_API_CALLS
-    std::lock_guard<std::mutex> guard (_audioSourceReadersMutex);
-#endif
     ARA_VALIDATE_API_ARGUMENT (audioReaderHostRef, ARA::contains (_audioSourceReaders, audioSourceReader));
     ARA_VALIDATE_API_THREAD (_araDocumentController->wasCreatedOnCurrentThread ());
+#if ARA_VALIDATE_API_CALLS
+    _validAudioSourceReaders.erase (audioSourceReader);
+#endif
     ARA::find_erase (_audioSourceReaders, audioSourceReader);
 }
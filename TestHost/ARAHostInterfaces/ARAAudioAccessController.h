@@ -27,7 +27,12 @@
 
 #include "ARADocumentController.h"
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <mutex>
+#include <unordered_set>
 
 /*******************************************************************************/
 // Simple audio source reader class that will be passed to readAudioSamples
@@ -76,15 +81,50 @@ public:
 
     Document* getDocument () const noexcept { return _araDocumentController->getDocument (); }
 
+    // Total number of sample frames read by the plug-in so far, allowing tests to validate the plug-in's I/O
+    int64_t getReadSampleFrameCount () const noexcept { return _readSampleFrameCount.load (); }
+
 #if ARA_VALIDATE_API_CALLS
     static void registerRenderThread ();
     static void unregisterRenderThread ();
 #endif
 
 private:
+#if ARA_VALIDATE_API_CALLS
+    // Set of the currently valid readers, used to validate the reader references passed to
+    // readAudioSamples () which may be called concurrently from many analysis threads.
+    // The set is split into shards by reader address, each with its own lock, so that threads
+    // reading from different readers rarely contend for the same lock.
+    class ValidReadersSet
+    {
+    public:
+        void insert (const AudioSourceReader* reader);
+        void erase (const AudioSourceReader* reader);
+        bool contains (const AudioSourceReader* reader);
+
+    private:
+        static constexpr size_t shardCount { 16 };
+
+        struct Shard
+        {
+            std::mutex _mutex;
+            std::unordered_set<const AudioSourceReader*> _readers;
+        };
+
+        Shard& getShard (const AudioSourceReader* reader) noexcept
+        {
+            // the low bits of heap addresses are always 0 due to alignment, so skip them
+            return _shards[(reinterpret_cast<uintptr_t> (reader) / alignof (std::max_align_t)) % shardCount];
+        }
+
+        std::array<Shard, shardCount> _shards;
+    };
+#endif
+
     ARADocumentController* _araDocumentController;
-    std::vector<std::unique_ptr<AudioSourceReader>> _audioSourceReaders;
+    std::vector<std::unique_ptr<AudioSourceReader>> _audioSourceReaders;    // only accessed on the main thread
+    std::atomic<int64_t> _readSampleFrameCount { 0 };
 #if ARA_VALIDATE_API_CALLS
-    std::mutex _audioSourceReadersMutex;
+    ValidReadersSet _validAudioSourceReaders;
 #endif
 };
@@ -25,48 +25,174 @@
 
 #include "ARAContentAccessController.h"
 
+#include <algorithm>
+
 /*******************************************************************************/
-// Template-based implementations of HostDataContentReader
+// Helper functions to determine the range of events relevant for a given time range via binary search.
+// Content readers are allowed to return events outside the requested range, so these may err on the
+// inclusive side, e.g. notes that end before the range but follow a long note that intersects it.
+
+// Notes: from the first note that may still sound at range start to the last note starting before range end.
+static std::pair<size_t, size_t> getNotesEventRange (const ContentContainer* contentContainer, const ARA::ARAContentTimeRange& range)
+{
+    const auto& notes { *contentContainer->getNotes () };
+    const auto& maxEndPositions { *contentContainer->getNoteMaxEndPositions () };
+    const auto rangeEnd { range.start + range.duration };
+    const auto first { std::upper_bound (maxEndPositions.begin (), maxEndPositions.end (), range.start) - maxEndPositions.begin () };
+    const auto last { std::lower_bound (notes.begin () + first, notes.end (), rangeEnd,
+                                        [] (const ARA::ARAContentNote& note, ARA::ARATimePosition position) { return note.startPosition < position; } ) - notes.begin () };
+    return { static_cast<size_t> (first), static_cast<size_t> (last) };
+}
+
+// Tempo entries: include the entries directly before and after the range so that
+// the plug-in can properly interpolate across the entire range. Since ARA requires tempo maps
+// to contain at least 2 entries, ranges outside of the map yield its first or last 2 entries.
+static std::pair<size_t, size_t> getTempoEntriesEventRange (const ContentContainer* contentContainer, const ARA::ARAContentTimeRange& range)
+{
+    const auto& tempoEntries { *contentContainer->getTempoEntries () };
+    const auto rangeEnd { range.start + range.duration };
+    const auto isBefore { [] (ARA::ARATimePosition position, const ARA::ARAContentTempoEntry& entry) { return position < entry.timePosition; } };
+    auto first { std::upper_bound (tempoEntries.begin (), tempoEntries.end (), range.start, isBefore) - tempoEntries.begin () };
+    auto last { std::upper_bound (tempoEntries.begin () + first, tempoEntries.end (), rangeEnd, isBefore) - tempoEntries.begin () };
+    if (first > 0)
+        --first;
+    const auto size { static_cast<ptrdiff_t> (tempoEntries.size ()) };
+    if (last < size)
+        ++last;
+    while ((last - first < 2) && (last - first < size))
+    {
+        if (last < size)
+            ++last;
+        else
+            --first;
+    }
+    return { static_cast<size_t> (first), static_cast<size_t> (last) };
+}
+
+// Converts a time position to quarters using the container's tempo map, extrapolating beyond its borders.
+// Returns false if the container does not provide a tempo map.
+static bool getQuarterPositionForTime (const ContentContainer* contentContainer, ARA::ARATimePosition timePosition, ARA::ARAQuarterPosition& quarterPosition)
+{
+    const auto& tempoEntries { contentContainer->getTempoEntries () };
+    if (!tempoEntries || (tempoEntries->size () < 2))
+        return false;
+
+    const auto it { std::upper_bound (tempoEntries->begin () + 1, tempoEntries->end () - 1, timePosition,
+                                      [] (ARA::ARATimePosition position, const ARA::ARAContentTempoEntry& entry) { return position < entry.timePosition; } ) };
+    const auto& left { *(it - 1) };
+    const auto& right { *it };
+    quarterPosition = left.quarterPosition + (timePosition - left.timePosition) * (right.quarterPosition - left.quarterPosition) / (right.timePosition - left.timePosition);
+    return true;
+}
+
+// Bar signatures, key signatures and chords are positioned in quarters and remain valid until the next
+// event - include the event that is valid at range start and all events that start within the range.
 template <typename ContentType>
-class ContentReaderImplementation : public HostDataContentReader
+static std::pair<size_t, size_t> getMusicalEventRange (const ContentContainer* contentContainer, const ContentContainer::EntryData<ContentType>& entries, const ARA::ARAContentTimeRange& range)
 {
-public:
-    explicit ContentReaderImplementation (const ContentContainer::EntryData<ContentType>& entries)
-    : _entries { entries }
-    {}
+    ARA::ARAQuarterPosition rangeStart, rangeEnd;
+    if (!getQuarterPositionForTime (contentContainer, range.start, rangeStart) ||
+        !getQuarterPositionForTime (contentContainer, range.start + range.duration, rangeEnd))
+        return { 0, entries->size () };
+
+    const auto isBefore { [] (ARA::ARAQuarterPosition position, const ContentType& entry) { return position < entry.position; } };
+    auto first { std::upper_bound (entries->begin (), entries->end (), rangeStart, isBefore) - entries->begin () };
+    const auto last { std::lower_bound (entries->begin () + first, entries->end (), rangeEnd,
+                                        [] (const ContentType& entry, ARA::ARAQuarterPosition position) { return entry.position < position; } ) - entries->begin () };
+    if (first > 0)
+        --first;
+    return { static_cast<size_t> (first), static_cast<size_t> (last) };
+}
 
-    bool hasData () const noexcept override { return _entries != nullptr; }
-    const void* getDataForEvent (ARA::ARAInt32 eventIndex) const noexcept override { return &this->_entries->at (static_cast<size_t> (eventIndex)); }
-    ARA::ARAInt32 getEventCount () const noexcept override { return static_cast<ARA::ARAInt32> (this->_entries->size ()); }
+/*******************************************************************************/
 
-private:
-    const ContentContainer::EntryData<ContentType>& _entries;
-};
+template <typename ContentType>
+static std::pair<size_t, size_t> getAllEventsRange (const ContentContainer::EntryData<ContentType>& entries)
+{
+    return { 0, entries->size () };
+}
 
 /*******************************************************************************/
 
-std::unique_ptr<HostDataContentReader> ARAContentAccessController::createContentReader (const ContentContainer* contentContainer, const ARA::ARAContentType type)
+ARA::ARAContentReaderHostRef ARAContentAccessController::createContentReader (const ContentContainer* contentContainer, const ARA::ARAContentType type, const ARA::ARAContentTimeRange* range) noexcept
 {
+    if (!isContentAvailable (contentContainer, type))
+        return nullptr;
+
+    // recycle a previously destroyed reader if possible to avoid heap traffic when plug-ins poll content frequently
+    if (_unusedHostDataContentReaders.empty ())
+        _unusedHostDataContentReaders.emplace_back (std::make_unique<HostDataContentReader> ());
+    auto contentReader { std::move (_unusedHostDataContentReaders.back ()) };
+    _unusedHostDataContentReaders.pop_back ();
+
     switch (type)
     {
-        case ARA::kARAContentTypeNotes: return std::make_unique<ContentReaderImplementation<ARA::ARAContentNote>> (contentContainer->getNotes ());
-        case ARA::kARAContentTypeTempoEntries: return std::make_unique<ContentReaderImplementation<ARA::ARAContentTempoEntry>> (contentContainer->getTempoEntries ());
-        case ARA::kARAContentTypeBarSignatures: return std::make_unique<ContentReaderImplementation<ARA::ARAContentBarSignature>> (contentContainer->getBarSignatures ());
-        case ARA::kARAContentTypeStaticTuning: return std::make_unique<ContentReaderImplementation<ARA::ARAContentTuning>> (contentContainer->getTuning ());
-        case ARA::kARAContentTypeKeySignatures: return std::make_unique<ContentReaderImplementation<ARA::ARAContentKeySignature>> (contentContainer->getKeySignatures ());
-        case ARA::kARAContentTypeSheetChords: return std::make_unique<ContentReaderImplementation<ARA::ARAContentChord>> (contentContainer->getChords ());
-        default: return nullptr;
+        case ARA::kARAContentTypeNotes:
+        {
+            const auto& notes { contentContainer->getNotes () };
+            contentReader->setEntries (notes, (range) ? getNotesEventRange (contentContainer, *range) : getAllEventsRange (notes));
+            break;
+        }
+        case ARA::kARAContentTypeTempoEntries:
+        {
+            const auto& tempoEntries { contentContainer->getTempoEntries () };
+            contentReader->setEntries (tempoEntries, (range) ? getTempoEntriesEventRange (contentContainer, *range) : getAllEventsRange (tempoEntries));
+            break;
+        }
+        case ARA::kARAContentTypeBarSignatures:
+        {
+            const auto& barSignatures { contentContainer->getBarSignatures () };
+            contentReader->setEntries (barSignatures, (range) ? getMusicalEventRange (contentContainer, barSignatures, *range) : getAllEventsRange (barSignatures));
+            break;
+        }
+        case ARA::kARAContentTypeStaticTuning:
+        {
+            const auto& tuning { contentContainer->getTuning () };
+            contentReader->setEntries (tuning, getAllEventsRange (tuning));
+            break;
+        }
+        case ARA::kARAContentTypeKeySignatures:
+        {
+            const auto& keySignatures { contentContainer->getKeySignatures () };
+            contentReader->setEntries (keySignatures, (range) ? getMusicalEventRange (contentContainer, keySignatures, *range) : getAllEventsRange (keySignatures));
+            break;
+        }
+        case ARA::kARAContentTypeSheetChords:
+        {
+            const auto& chords { contentContainer->getChords () };
+            contentReader->setEntries (chords, (range) ? getMusicalEventRange (contentContainer, chords, *range) : getAllEventsRange (chords));
+            break;
+        }
+        default:
+        {
+            ARA_INTERNAL_ASSERT (false);
+            break;
+        }
     }
+
+    const auto hostRef { toHostRef (contentReader.get ()) };
+    _hostDataContentReaders.emplace_back (std::move (contentReader));
+    return hostRef;
 }
 
-bool ARAContentAccessController::isContentAvailable (const ContentContainer* contentContainer, const ARA::ARAContentType type)
+// Availability is queried directly on the content container, so plug-ins can poll it without any allocations.
+bool ARAContentAccessController::isContentAvailable (const ContentContainer* contentContainer, const ARA::ARAContentType type) noexcept
 {
-    return createContentReader (contentContainer, type)->hasData ();
+    switch (type)
+    {
+        case ARA::kARAContentTypeNotes: return contentContainer->getNotes () != nullptr;
+        case ARA::kARAContentTypeTempoEntries: return contentContainer->getTempoEntries () != nullptr;
+        case ARA::kARAContentTypeBarSignatures: return contentContainer->getBarSignatures () != nullptr;
+        case ARA::kARAContentTypeStaticTuning: return contentContainer->getTuning () != nullptr;
+        case ARA::kARAContentTypeKeySignatures: return contentContainer->getKeySignatures () != nullptr;
+        case ARA::kARAContentTypeSheetChords: return contentContainer->getChords () != nullptr;
+        default: return false;
+    }
 }
 
 // For the available content we can indicate a "grade" of how reliable the content data is -
 // in this test host the content is "adjusted" because we simulate that the end user described this through some UI.
-ARA::ARAContentGrade ARAContentAccessController::getContentGrade (const ContentContainer* contentContainer, const ARA::ARAContentType type)
+ARA::ARAContentGrade ARAContentAccessController::getContentGrade (const ContentContainer* contentContainer, const ARA::ARAContentType type) noexcept
 {
     if (isContentAvailable (contentContainer, type))
         return ARA::kARAContentGradeAdjusted;
@@ -93,21 +219,14 @@ ARA::ARAContentGrade ARAContentAccessController::getMusicalContextContentGrade (
     return getContentGrade (musicalContext, type);
 }
 
-ARA::ARAContentReaderHostRef ARAContentAccessController::createMusicalContextContentReader (ARA::ARAMusicalContextHostRef musicalContextHostRef, ARA::ARAContentType type, const ARA::ARAContentTimeRange* /*range*/) noexcept
+ARA::ARAContentReaderHostRef ARAContentAccessController::createMusicalContextContentReader (ARA::ARAMusicalContextHostRef musicalContextHostRef, ARA::ARAContentType type, const ARA::ARAContentTimeRange* range) noexcept
 {
     const auto musicalContext = fromHostRef (musicalContextHostRef);
     ARA_VALIDATE_API_ARGUMENT (musicalContextHostRef, ARA::contains (getDocument ()->getMusicalContexts (), musicalContext));
     ARA_VALIDATE_API_STATE (isContentAvailable (musicalContext, type));
     ARA_VALIDATE_API_THREAD (_araDocumentController->wasCreatedOnCurrentThread ());
 
-    if (auto contentReader { createContentReader (musicalContext, type) })
-    {
-        const auto hostRef { toHostRef (contentReader.get ()) };
-        _hostDataContentReaders.emplace_back (std::move (contentReader));
-        return hostRef;
-    }
-
-    return nullptr;
+    return createContentReader (musicalContext, type, range);
 }
 
 bool ARAContentAccessController::isAudioSourceContentAvailable (ARA::ARAAudioSourceHostRef audioSourceHostRef, ARA::ARAContentType type) noexcept
@@ -129,21 +248,14 @@ ARA::ARAContentGrade ARAContentAccessController::getAudioSourceContentGrade (ARA
     return getContentGrade (audioSource, type);
 }
 
-ARA::ARAContentReaderHostRef ARAContentAccessController::createAudioSourceContentReader (ARA::ARAAudioSourceHostRef audioSourceHostRef, ARA::ARAContentType type, const ARA::ARAContentTimeRange* /*range*/) noexcept
+ARA::ARAContentReaderHostRef ARAContentAccessController::createAudioSourceContentReader (ARA::ARAAudioSourceHostRef audioSourceHostRef, ARA::ARAContentType type, const ARA::ARAContentTimeRange* range) noexcept
 {
     const auto audioSource = fromHostRef (audioSourceHostRef);
     ARA_VALIDATE_API_ARGUMENT (audioSource, ARA::contains (getDocument ()->getAudioSources (), audioSource));
     ARA_VALIDATE_API_STATE (isContentAvailable (audioSource, type));
     ARA_VALIDATE_API_THREAD (_araDocumentController->wasCreatedOnCurrentThread ());
 
-    if (auto contentReader { createContentReader (audioSource, type) })
-    {
-        const auto hostRef { toHostRef (contentReader.get ()) };
-        _hostDataContentReaders.emplace_back (std::move (contentReader));
-        return hostRef;
-    }
-
-    return nullptr;
+    return createContentReader (audioSource, type, range);
 }
 
 ARA::ARAInt32 ARAContentAccessController::getContentReaderEventCount (ARA::ARAContentReaderHostRef contentReaderHostRef) noexcept
@@ -172,5 +284,10 @@ void ARAContentAccessController::destroyContentReader (ARA::ARAContentReaderHost
     ARA_VALIDATE_API_ARGUMENT (contentReaderHostRef, ARA::contains (_hostDataContentReaders, hostDataContentReader));
     ARA_VALIDATE_API_THREAD (_araDocumentController->wasCreatedOnCurrentThread ());
 
-    ARA::find_erase (_hostDataContentReaders, hostDataContentReader);
+    // release the pinned content and keep the reader around for reuse
+    const auto it { std::find_if (_hostDataContentReaders.begin (), _hostDataContentReaders.end (),
+                                  [hostDataContentReader] (const std::unique_ptr<HostDataContentReader>& contentReader) { return contentReader.get () == hostDataContentReader; } ) };
+    (*it)->clearEntries ();
+    _unusedHostDataContentReaders.emplace_back (std::move (*it));
+    _hostDataContentReaders.erase (it);
 }
@@ -27,19 +27,45 @@
 
 #include "ARADocumentController.h"
 
+#include <cstdint>
+#include <utility>
+
 /*******************************************************************************/
 // Simple content reader class that will be passed as ARAContentReaderHostRef
+// The reader pins the content snapshot it was created with, so the host may update
+// the content while the plug-in is still reading without invalidating the reader.
+// Since the type of content is erased here, all readers share the same class and
+// can be recycled by the content access controller instead of being reallocated.
 class HostDataContentReader
 {
 public:
-    virtual ~HostDataContentReader () = default;
+    HostDataContentReader () = default;
 
-    virtual bool hasData () const noexcept = 0;
-    virtual const void* getDataForEvent (ARA::ARAInt32 eventIndex) const noexcept = 0;
-    virtual ARA::ARAInt32 getEventCount () const noexcept = 0;
+    // if a time range was requested, the reader only exposes the relevant sub-range of the snapshot
+    template <typename ContentType>
+    void setEntries (ContentContainer::EntryData<ContentType> entries, std::pair<size_t, size_t> eventRange) noexcept
+    {
+        _eventData = entries->data () + eventRange.first;
+        _eventSize = sizeof (ContentType);
+        _eventCount = static_cast<ARA::ARAInt32> (eventRange.second - eventRange.first);
+        _entries = std::move (entries);
+    }
+    void clearEntries () noexcept
+    {
+        _entries.reset ();
+        _eventData = nullptr;
+        _eventCount = 0;
+    }
+
+    const void* getDataForEvent (ARA::ARAInt32 eventIndex) const noexcept { return static_cast<const uint8_t*> (_eventData) + static_cast<size_t> (eventIndex) * _eventSize; }
+    ARA::ARAInt32 getEventCount () const noexcept { return _eventCount; }
+
+private:
+    std::shared_ptr<const void> _entries;
+    const void* _eventData { nullptr };
+    size_t _eventSize { 0 };
+    ARA::ARAInt32 _eventCount { 0 };
 
-protected:
-    HostDataContentReader () = default;
     ARA_PLUGIN_MANAGED_OBJECT (HostDataContentReader)
 };
 ARA_MAP_HOST_REF (HostDataContentReader, ARA::ARAContentReaderHostRef)
@@ -68,13 +94,14 @@ public:
     void destroyContentReader (ARA::ARAContentReaderHostRef contentReaderHostRef) noexcept override;
 
 private:
-    static std::unique_ptr<HostDataContentReader> createContentReader (const ContentContainer* contentContainer, const ARA::ARAContentType type);
-    static bool isContentAvailable (const ContentContainer* contentContainer, const ARA::ARAContentType type);
-    static ARA::ARAContentGrade getContentGrade (const ContentContainer* contentContainer, const ARA::ARAContentType type);
+    ARA::ARAContentReaderHostRef createContentReader (const ContentContainer* contentContainer, const ARA::ARAContentType type, const ARA::ARAContentTimeRange* range) noexcept;
+    static bool isContentAvailable (const ContentContainer* contentContainer, const ARA::ARAContentType type) noexcept;
+    static ARA::ARAContentGrade getContentGrade (const ContentContainer* contentContainer, const ARA::ARAContentType type) noexcept;
 
     Document* getDocument () const noexcept { return _araDocumentController->getDocument (); }
 
 private:
     std::vector<std::unique_ptr<HostDataContentReader>> _hostDataContentReaders;
+    std::vector<std::unique_ptr<HostDataContentReader>> _unusedHostDataContentReaders;   // pool of destroyed readers, recycled upon creation
     ARADocumentController* _araDocumentController;
 };
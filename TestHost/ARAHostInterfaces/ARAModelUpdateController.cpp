@@ -72,6 +72,12 @@ void ARAModelUpdateController::notifyAudioSourceAnalysisProgress (ARA::ARAAudioS
     }
 }
 
+float ARAModelUpdateController::getAnalysisProgress (AudioSource* audioSource) const noexcept
+{
+    const auto it { _audioSourceAnalysisProgressValues.find (audioSource) };
+    return (it != _audioSourceAnalysisProgressValues.end ()) ? it->second : -1.0f;
+}
+
 // The plug-in will call this function to let us know that it has some sort of new content for an audio source
 // This could happen if, say, the plug-in detects notes within an audio source
 void ARAModelUpdateController::notifyAudioSourceContentChanged (ARA::ARAAudioSourceHostRef audioSourceHostRef, const ARA::ARAContentTimeRange* range, ARA::ContentUpdateScopes scopeFlags) noexcept
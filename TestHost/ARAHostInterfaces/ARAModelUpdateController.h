@@ -58,6 +58,9 @@ public:
 
     void setMinimalContentUpdateLogging (bool flag) { _minimalContentUpdateLogging = flag; }
 
+    // returns the most recent analysis progress reported for the audio source, or a negative value if it is not being analyzed
+    float getAnalysisProgress (AudioSource* audioSource) const noexcept;
+
 private:
     Document* getDocument () const noexcept { return _araDocumentController->getDocument (); }
 
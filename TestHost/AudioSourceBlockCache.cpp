@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------
+//! \file       AudioSourceBlockCache.cpp
+//!             shared cache of decoded audio sample blocks for the test host
+//! \project    ARA SDK Examples
+//! \copyright  Copyright (c) 2018-2025, Celemony Software GmbH, All Rights Reserved.
+//! \license    Licensed under the Apache License, Version 2.0 (the "License");
+//!             you may not use this file except in compliance with the License.
+//!             You may obtain a copy of the License at
+//!
+//!               http://www.apache.org/licenses/LICENSE-2.0
+//!
+//!             Unless required by applicable law or agreed to in writing, software
+//!             distributed under the License is distributed on an "AS IS" BASIS,
+//!             WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//!             See the License for the specific language governing permissions and
+//!             limitations under the License.
+//------------------------------------------------------------------------------
+// This is a brief test app that hooks up an ARA capable plug-in using a choice
+// of several companion APIs, creates a small model, performs various tests and
+// sanity checks and shuts everything down again.
+// This educational example is not suitable for production code - for the sake
+// of readability of the code, proper error handling or dealing with optional
+// ARA API elements is left out.
+//------------------------------------------------------------------------------
+
+#include "AudioSourceBlockCache.h"
+
+#include <algorithm>
+#include <cstring>
+
+constexpr int64_t AudioSourceBlockCache::blockSize;     // prior to C++17, constexpr members that are ODR-used (e.g. by std::min ()) must be defined out-of-class
+
+AudioSourceBlockCache::AudioSourceBlockCache (AudioFileBase* audioFile, size_t maxBlockCount)
+: _audioFile { audioFile },
+  _maxBlockCountPerShard { std::max (static_cast<size_t> (1), maxBlockCount / shardCount) }
+{}
+
+bool AudioSourceBlockCache::readSamples (int64_t samplePosition, int64_t samplesPerChannel, void* const buffers[], bool use64BitSamples) noexcept
+{
+    // requests that exceed the audio file are passed through unaltered
+    const auto sampleCount { _audioFile->getSampleCount () };
+    const auto endPosition { samplePosition + samplesPerChannel };
+    if ((samplePosition < 0) || (samplesPerChannel < 0) || (endPosition > sampleCount))
+        return _audioFile->readSamples (samplePosition, samplesPerChannel, buffers, use64BitSamples);
+
+    const auto channelCount { _audioFile->getChannelCount () };
+    const size_t sampleSize { (use64BitSamples) ? sizeof (double) : sizeof (float) };
+    auto position { samplePosition };
+    while (position < endPosition)
+    {
+        const auto blockIndex { position / blockSize };
+        const auto block { getBlock (blockIndex, use64BitSamples) };
+        if (!block)
+            return false;
+
+        const auto blockStart { blockIndex * blockSize };
+        const auto blockSampleCount { std::min (blockSize, sampleCount - blockStart) };
+        const auto copyCount { std::min (endPosition, blockStart + blockSampleCount) - position };
+        for (auto c { 0 }; c < channelCount; ++c)
+            std::memcpy (static_cast<uint8_t*> (buffers[c]) + static_cast<size_t> (position - samplePosition) * sampleSize,
+                         block->data () + static_cast<size_t> (c * blockSampleCount + position - blockStart) * sampleSize,
+                         static_cast<size_t> (copyCount) * sampleSize);
+        position += copyCount;
+    }
+    return true;
+}
+
+void AudioSourceBlockCache::clear ()
+{
+    for (auto& shard : _shards)
+    {
+        std::lock_guard<std::mutex> lock { shard._mutex };
+        shard._entries.clear ();
+        shard._lruList.clear ();
+    }
+}
+
+AudioSourceBlockCache::Block AudioSourceBlockCache::getBlock (int64_t blockIndex, bool use64BitSamples)
+{
+    const Key key { blockIndex, use64BitSamples };
+    auto& shard { _shards[static_cast<size_t> (blockIndex) % shardCount] };
+    {
+        std::lock_guard<std::mutex> lock { shard._mutex };
+        const auto it { shard._entries.find (key) };
+        if (it != shard._entries.end ())
+        {
+            shard._lruList.splice (shard._lruList.begin (), shard._lruList, it->second);
+            ++_hitCount;
+            return it->second->second;
+        }
+    }
+
+    // read the block without holding the lock so that the other blocks in this shard remain accessible -
+    // if several threads miss the same block concurrently, each reads it and the first one is kept
+    ++_missCount;
+    const auto blockStart { blockIndex * blockSize };
+    const auto blockSampleCount { static_cast<size_t> (std::min (blockSize, _audioFile->getSampleCount () - blockStart)) };
+    const auto channelCount { static_cast<size_t> (_audioFile->getChannelCount ()) };
+    const size_t sampleSize { (use64BitSamples) ? sizeof (double) : sizeof (float) };
+    auto data { std::make_shared<std::vector<uint8_t>> (channelCount * blockSampleCount * sampleSize) };
+    std::vector<void*> channelBuffers;
+    for (size_t c { 0 }; c < channelCount; ++c)
+        channelBuffers.push_back (data->data () + c * blockSampleCount * sampleSize);
+    if (!_audioFile->readSamples (blockStart, static_cast<int64_t> (blockSampleCount), channelBuffers.data (), use64BitSamples))
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock { shard._mutex };
+    const auto it { shard._entries.find (key) };
+    if (it != shard._entries.end ())
+        return it->second->second;
+
+    shard._lruList.emplace_front (key, std::move (data));
+    shard._entries[key] = shard._lruList.begin ();
+    if (shard._lruList.size () > _maxBlockCountPerShard)
+    {
+        shard._entries.erase (shard._lruList.back ().first);
+        shard._lruList.pop_back ();
+    }
+    return shard._lruList.front ().second;
+}
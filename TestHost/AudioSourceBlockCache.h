@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+//! \file       AudioSourceBlockCache.h
+//!             shared cache of decoded audio sample blocks for the test host
+//! \project    ARA SDK Examples
+//! \copyright  Copyright (c) 2018-2025, Celemony Software GmbH, All Rights Reserved.
+//! \license    Licensed under the Apache License, Version 2.0 (the "License");
+//!             you may not use this file except in compliance with the License.
+//!             You may obtain a copy of the License at
+//!
+//!               http://www.apache.org/licenses/LICENSE-2.0
+//!
+//!             Unless required by applicable law or agreed to in writing, software
+//!             distributed under the License is distributed on an "AS IS" BASIS,
+//!             WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//!             See the License for the specific language governing permissions and
+//!             limitations under the License.
+//------------------------------------------------------------------------------
+// This is a brief test app that hooks up an ARA capable plug-in using a choice
+// of several companion APIs, creates a small model, performs various tests and
+// sanity checks and shuts everything down again.
+// This educational example is not suitable for production code - for the sake
+// of readability of the code, proper error handling or dealing with optional
+// ARA API elements is left out.
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "ExamplesCommon/AudioFiles/AudioFiles.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/*******************************************************************************/
+// Thread-safe LRU cache of sample blocks read from an audio file, shared by all readers of an
+// audio source so that reading the same data multiple times (e.g. for analysis and rendering)
+// does not require decoding it again.
+// Blocks are keyed by their index and sample format (32 or 64 bit). To allow concurrent readers
+// to access the cache without contending for a single lock, it is split into shards by block index,
+// each with its own lock and LRU list.
+class AudioSourceBlockCache
+{
+public:
+    static constexpr int64_t blockSize { 16384 };
+    static constexpr size_t shardCount { 8 };
+    static constexpr size_t defaultMaxBlockCount { 256 };
+
+    struct Statistics
+    {
+        uint64_t hitCount;
+        uint64_t missCount;
+    };
+
+    explicit AudioSourceBlockCache (AudioFileBase* audioFile, size_t maxBlockCount = defaultMaxBlockCount);
+
+    // same semantics as AudioFileBase::readSamples ()
+    bool readSamples (int64_t samplePosition, int64_t samplesPerChannel, void* const buffers[], bool use64BitSamples) noexcept;
+
+    // must be called if the samples of the audio file change
+    void clear ();
+
+    Statistics getStatistics () const noexcept { return { _hitCount.load (), _missCount.load () }; }
+
+private:
+    using Key = std::pair<int64_t, bool>;                       // block index and use64BitSamples
+    using Block = std::shared_ptr<const std::vector<uint8_t>>;  // samples of all channels, stored one channel after another
+    using LRUList = std::list<std::pair<Key, Block>>;           // most recently used first
+
+    struct Shard
+    {
+        std::mutex _mutex;
+        LRUList _lruList;
+        std::map<Key, LRUList::iterator> _entries;
+    };
+
+    Block getBlock (int64_t blockIndex, bool use64BitSamples);
+
+    AudioFileBase* const _audioFile;
+    const size_t _maxBlockCountPerShard;
+    std::array<Shard, shardCount> _shards;
+    std::atomic<uint64_t> _hitCount { 0 };
+    std::atomic<uint64_t> _missCount { 0 };
+};
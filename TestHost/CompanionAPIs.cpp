@@ -292,6 +292,16 @@ public:
         CLAPRenderBuffer (_clapPlugIn, static_cast<uint32_t> (blockSize), samplePosition, buffer);
     }
 
+    bool supports64BitSamples () override
+    {
+        return CLAPSupports64BitSamples (_clapPlugIn);
+    }
+
+    void renderSamples64 (int blockSize, int64_t samplePosition, double* buffer) override
+    {
+        CLAPRenderBuffer64 (_clapPlugIn, static_cast<uint32_t> (blockSize), samplePosition, buffer);
+    }
+
     void stopRendering () override
     {
         CLAPStopRendering (_clapPlugIn);
@@ -54,6 +54,11 @@ public:
     virtual void renderSamples (int blockSize, int64_t samplePosition, float* buffer) = 0;
     virtual void stopRendering () = 0;
 
+    // Optional rendering with 64 bit samples - supports64BitSamples () is valid after startRendering (),
+    // renderSamples64 () may only be called if it returns true
+    virtual bool supports64BitSamples () { return false; }
+    virtual void renderSamples64 (int /*blockSize*/, int64_t /*samplePosition*/, double* /*buffer*/) { ARA_INTERNAL_ASSERT (false); }
+
     // Getters for ARA specific plug-in role interfaces
     ARA::Host::PlaybackRenderer getPlaybackRenderer () { return ARA::Host::PlaybackRenderer { _instance }; }
     ARA::Host::EditorRenderer getEditorRenderer () { return ARA::Host::EditorRenderer { _instance }; }
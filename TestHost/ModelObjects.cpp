@@ -26,6 +26,36 @@
 #include "ModelObjects.h"
 #include "ARA_Library/Debug/ARADebug.h"
 
+#include <algorithm>
+
+/*******************************************************************************/
+
+void ContentContainer::setNotes (std::vector<ARA::ARAContentNote> notes)
+{
+    const auto isEarlier { [] (const ARA::ARAContentNote& a, const ARA::ARAContentNote& b) { return a.startPosition < b.startPosition; } };
+    if (!std::is_sorted (notes.begin (), notes.end (), isEarlier))
+        std::stable_sort (notes.begin (), notes.end (), isEarlier);
+
+    setNotes (makeEntryData (std::move (notes)));
+}
+
+void ContentContainer::setNotes (EntryData<ARA::ARAContentNote> notes)
+{
+    ARA_INTERNAL_ASSERT (notes != nullptr);
+    ARA_INTERNAL_ASSERT (std::is_sorted (notes->begin (), notes->end (), [] (const ARA::ARAContentNote& a, const ARA::ARAContentNote& b) { return a.startPosition < b.startPosition; }));
+
+    std::vector<ARA::ARATimePosition> maxEndPositions;
+    maxEndPositions.reserve (notes->size ());
+    for (const auto& note : *notes)
+    {
+        const auto endPosition { note.startPosition + std::max (note.noteDuration, note.signalDuration) };
+        maxEndPositions.push_back (maxEndPositions.empty () ? endPosition : std::max (maxEndPositions.back (), endPosition));
+    }
+
+    _notes = std::move (notes);
+    _noteMaxEndPositions = makeEntryData (std::move (maxEndPositions));
+}
+
 /*******************************************************************************/
 
 Document::Document (std::string name)
@@ -81,6 +111,7 @@ void RegionSequence::setMusicalContext (MusicalContext* musicalContext)
 AudioSource::AudioSource (Document* document, AudioFileBase* audioFile, std::string persistentID)
 : _document { document },
   _audioFile { audioFile },
+  _blockCache { std::make_unique<AudioSourceBlockCache> (audioFile) },
   _persistentID { persistentID }
 {
     // at this point, only up to stereo formats are supported because the test code
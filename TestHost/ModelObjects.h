@@ -33,6 +33,9 @@
 #include "ExamplesCommon/Utilities/StdUniquePtrUtilities.h"
 #include "ExamplesCommon/AudioFiles/AudioFiles.h"
 
+#include "AudioSourceBlockCache.h"
+
+#include <memory>
 #include <string>
 
 class Document;
@@ -45,21 +48,31 @@ class PlaybackRegion;
 /*******************************************************************************/
 
 // Shared base class for audio sources and musical contexts, which can both store content information.
+// The content is stored as immutable snapshots that can be shared without copying: setting new content
+// replaces the snapshot, while any content reader that still uses the previous snapshot keeps it alive.
+// All content is kept sorted by position so that content readers can efficiently filter by time range:
+// ARA requires this for all timeline and harmonic content already, and notes are sorted when being set.
 class ContentContainer
 {
 public:
     template<typename ContentType>
-    using EntryData = std::unique_ptr<std::vector<ContentType>>;
+    using EntryData = std::shared_ptr<const std::vector<ContentType>>;
 
-    void setNotes (std::vector<ARA::ARAContentNote> const& notes) { _notes = makeEntryData (notes); }
-    void clearNotes () { _notes.reset (); }
+    void setNotes (std::vector<ARA::ARAContentNote> notes);
+    void setNotes (EntryData<ARA::ARAContentNote> notes);
+    void clearNotes () { _notes.reset (); _noteMaxEndPositions.reset (); }
     const EntryData<ARA::ARAContentNote>& getNotes () const noexcept { return _notes; }
+    // for each note, the maximum end position of all notes up to and including it - since this is
+    // monotonic, it allows for binary search of the first note that may intersect a given time range
+    const EntryData<ARA::ARATimePosition>& getNoteMaxEndPositions () const noexcept { return _noteMaxEndPositions; }
 
-    void setTempoEntries (std::vector<ARA::ARAContentTempoEntry> const& tempoEntries) { _tempoEntries = makeEntryData (tempoEntries); }
+    void setTempoEntries (std::vector<ARA::ARAContentTempoEntry> tempoEntries) { _tempoEntries = makeEntryData (std::move (tempoEntries)); }
+    void setTempoEntries (EntryData<ARA::ARAContentTempoEntry> tempoEntries) noexcept { _tempoEntries = std::move (tempoEntries); }
     void clearTempoEntries () { _tempoEntries.reset (); }
     const EntryData<ARA::ARAContentTempoEntry>& getTempoEntries () const noexcept { return _tempoEntries; }
 
-    void setBarSignatures (std::vector<ARA::ARAContentBarSignature> const& barSignatures) { _barSignatures = makeEntryData (barSignatures); }
+    void setBarSignatures (std::vector<ARA::ARAContentBarSignature> barSignatures) { _barSignatures = makeEntryData (std::move (barSignatures)); }
+    void setBarSignatures (EntryData<ARA::ARAContentBarSignature> barSignatures) noexcept { _barSignatures = std::move (barSignatures); }
     void clearBarSignatures () { _barSignatures.reset (); }
     const EntryData<ARA::ARAContentBarSignature>& getBarSignatures () const noexcept { return _barSignatures; }
 
@@ -67,19 +80,22 @@ public:
     void clearTuning () { _tuning.reset (); }
     const EntryData<ARA::ARAContentTuning>& getTuning () const noexcept { return _tuning; }
 
-    void setKeySignatures (std::vector<ARA::ARAContentKeySignature> const& keySignatures) { _keySignatures = makeEntryData (keySignatures); }
+    void setKeySignatures (std::vector<ARA::ARAContentKeySignature> keySignatures) { _keySignatures = makeEntryData (std::move (keySignatures)); }
+    void setKeySignatures (EntryData<ARA::ARAContentKeySignature> keySignatures) noexcept { _keySignatures = std::move (keySignatures); }
     void clearKeySignatures () { _keySignatures.reset (); }
     const EntryData<ARA::ARAContentKeySignature>& getKeySignatures () const noexcept { return _keySignatures; }
 
-    void setChords (std::vector<ARA::ARAContentChord> const& chords) { _chords = makeEntryData (chords); }
+    void setChords (std::vector<ARA::ARAContentChord> chords) { _chords = makeEntryData (std::move (chords)); }
+    void setChords (EntryData<ARA::ARAContentChord> chords) noexcept { _chords = std::move (chords); }
     void clearChords () { _chords.reset (); }
     const EntryData<ARA::ARAContentChord>& getChords () const noexcept { return _chords; }
 
 private:
     template<typename ContentType>
-    EntryData<ContentType> makeEntryData (std::vector<ContentType> const& vec) { return std::make_unique<std::vector<ContentType>> (vec); }
+    static EntryData<ContentType> makeEntryData (std::vector<ContentType>&& vec) { return std::make_shared<const std::vector<ContentType>> (std::move (vec)); }
 
     EntryData<ARA::ARAContentNote> _notes;
+    EntryData<ARA::ARATimePosition> _noteMaxEndPositions;
     EntryData<ARA::ARAContentTempoEntry> _tempoEntries;
     EntryData<ARA::ARAContentBarSignature> _barSignatures;
     EntryData<ARA::ARAContentTuning> _tuning;
@@ -89,6 +105,23 @@ private:
 
 /*******************************************************************************/
 
+// Shared base class for all model objects that have a plug-in side representation.
+// Since each document is shared with exactly one ARA document controller, the plug-in
+// reference can be stored directly in the object instead of being looked up in a map.
+// Do not call setPlugInRef () directly: instead use the related calls at the ARADocumentController.
+template<typename RefType>
+class PlugInRefContainer
+{
+public:
+    RefType getPlugInRef () const noexcept { return _plugInRef; }
+    void setPlugInRef (RefType plugInRef) noexcept { _plugInRef = plugInRef; }
+
+private:
+    RefType _plugInRef { nullptr };
+};
+
+/*******************************************************************************/
+
 class Document
 {
 public:
@@ -118,7 +151,7 @@ private:
 
 /*******************************************************************************/
 
-class MusicalContext : public ContentContainer
+class MusicalContext : public ContentContainer, public PlugInRefContainer<ARA::ARAMusicalContextRef>
 {
 public:
     MusicalContext (Document* document, std::string name, ARA::ARAColor color);
@@ -147,7 +180,7 @@ private:
 
 /*******************************************************************************/
 
-class RegionSequence
+class RegionSequence : public PlugInRefContainer<ARA::ARARegionSequenceRef>
 {
 public:
     RegionSequence (Document* document, std::string name, MusicalContext* musicalContext, ARA::ARAColor color);
@@ -181,7 +214,7 @@ private:
 
 /*******************************************************************************/
 
-class AudioSource : public ContentContainer
+class AudioSource : public ContentContainer, public PlugInRefContainer<ARA::ARAAudioSourceRef>
 {
 public:
     AudioSource (Document* document, AudioFileBase* audioFile, std::string persistentID);
@@ -201,6 +234,9 @@ public:
     int getChannelCount () const noexcept { return _audioFile->getChannelCount (); }
     bool merits64BitSamples () const noexcept { return _audioFile->merits64BitSamples (); }
 
+    // all reading of samples should go through this cache, which is shared by all readers of the audio source
+    AudioSourceBlockCache& getBlockCache () const noexcept { return *_blockCache; }
+
     std::vector<std::unique_ptr<AudioModification>> const& getAudioModifications () const noexcept { return _audioModifications; }
     void addAudioModification (std::unique_ptr<AudioModification>&& modification) { _audioModifications.emplace_back (std::move (modification)); }
     void removeAudioModification (AudioModification* modification) { ARA::find_erase (_audioModifications, modification); }
@@ -208,13 +244,14 @@ public:
 private:
     Document* const _document;
     AudioFileBase* const _audioFile;
+    const std::unique_ptr<AudioSourceBlockCache> _blockCache;
     std::string _persistentID;
     std::vector<std::unique_ptr<AudioModification>> _audioModifications;
 };
 
 /*******************************************************************************/
 
-class AudioModification
+class AudioModification : public PlugInRefContainer<ARA::ARAAudioModificationRef>
 {
 public:
     AudioModification (AudioSource* audioSource, std::string name, std::string persistentID);
@@ -240,7 +277,7 @@ private:
 
 /*******************************************************************************/
 
-class PlaybackRegion
+class PlaybackRegion : public PlugInRefContainer<ARA::ARAPlaybackRegionRef>
 {
 public:
     PlaybackRegion (AudioModification* audioModification,
@@ -26,15 +26,22 @@
 #include "TestCases.h"
 #include "TestHost.h"
 #include "ARAHostInterfaces/ARAAudioAccessController.h"
+#include "ARAHostInterfaces/ARAContentAccessController.h"
+
+#include "ExamplesCommon/SignalProcessing/PulsedSineSignal.h"
 
 #include "ARA_Library/Utilities/ARASamplePositionConversion.h"
 #include "ARA_Library/Utilities/ARAStdVectorUtilities.h"
 
 #include "ARA_API/ARAAudioFileChunks.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdlib>
 #include <cstring>
 #include <cstdio>
+#include <limits>
 #include <thread>
 
 
@@ -112,16 +119,19 @@ ARADocumentController* createHostAndBasicDocument (PlugInEntry* plugInEntry, std
 
     // enable audio source samples access and
     // request the analysis for all available content types if this plug-in has any
+    // (requesting all audio sources at once so that the plug-in can analyze them concurrently)
     const auto araFactory { plugInEntry->getARAFactory () };
+    std::vector<AudioSource*> audioSources;
     for (auto& audioSource : document->getAudioSources ())
     {
         araDocumentController->enableAudioSourceSamplesAccess (audioSource.get (), true);
-
-        std::function<void (void)> waitFunction { [&] () { plugInEntry->idleThreadForDuration (50, true); } };
-        if (requestPlugInAnalysisAndBlock && araFactory->analyzeableContentTypesCount > 0)
-            araDocumentController->requestAudioSourceContentAnalysis (audioSource.get (), araFactory->analyzeableContentTypesCount, araFactory->analyzeableContentTypes, &waitFunction);
+        audioSources.push_back (audioSource.get ());
     }
 
+    std::function<void (int32_t)> waitFunction { [&] (int32_t milliseconds) { plugInEntry->idleThreadForDuration (milliseconds, true); } };
+    if (requestPlugInAnalysisAndBlock && araFactory->analyzeableContentTypesCount > 0)
+        araDocumentController->requestAudioSourcesContentAnalysis (audioSources, araFactory->analyzeableContentTypesCount, araFactory->analyzeableContentTypes, &waitFunction);
+
     if (requestPlugInAnalysisAndBlock)
         araDocumentController->setMinimalContentUpdateLogging (false);
 
@@ -270,6 +280,30 @@ void testContentUpdates (PlugInEntry* plugInEntry, const AudioFileList& audioFil
 }
 
 /*******************************************************************************/
+// Verifies that the host's tempo map readers provide at least 2 entries as required by ARA,
+// even if the plug-in requests a time range that lies partially or entirely outside of the map.
+static void validateHostTempoMapReading (ARADocumentController* araDocumentController)
+{
+    const auto musicalContext { araDocumentController->getDocument ()->getMusicalContexts ().front ().get () };
+    const std::vector<ARA::ARAContentTempoEntry> tempoEntries { { 0.0, 0.0 }, { 0.5, 1.0 }, { 1.0, 2.0 } };
+
+    araDocumentController->beginEditing ();
+    musicalContext->setTempoEntries (tempoEntries);
+    araDocumentController->updateMusicalContextContent (musicalContext, nullptr, ARA::ContentUpdateScopes::timelineIsAffected ());
+    araDocumentController->endEditing ();
+
+    const auto contentAccessController { araDocumentController->getContentAccessController () };
+    const ARA::ARAContentTimeRange ranges[] { { -10.0, 1.0 }, { -0.5, 1.0 }, { 0.6, 0.1 }, { 0.75, 10.0 }, { 10.0, 1.0 } };
+    for (const auto& range : ranges)
+    {
+        const auto contentReader { contentAccessController->createMusicalContextContentReader (toHostRef (musicalContext), ARA::kARAContentTypeTempoEntries, &range) };
+        const auto eventCount { contentAccessController->getContentReaderEventCount (contentReader) };
+        ARA_LOG ("Host tempo map reader for time range %.2f to %.2f provides %i entries", range.start, range.start + range.duration, eventCount);
+        ARA_INTERNAL_ASSERT (eventCount >= 2);
+        contentAccessController->destroyContentReader (contentReader);
+    }
+}
+
 // Demonstrates how to read ARAContentTypes from a plug-in -
 // see ContentLogger::log () for implementation of the actual content reading
 void testContentReading (PlugInEntry* plugInEntry, const AudioFileList& audioFiles)
@@ -294,6 +328,9 @@ void testContentReading (PlugInEntry* plugInEntry, const AudioFileList& audioFil
         }
     }
 
+    // also verify reading the host's content with time ranges
+    validateHostTempoMapReading (araDocumentController);
+
     plugInEntry->unlockDistributedMainThreadIfNeeded ();
 }
 
@@ -772,6 +809,52 @@ void testDragAndDrop (PlugInEntry* plugInEntry, const AudioFileList& audioFiles)
     plugInEntry->unlockDistributedMainThreadIfNeeded ();
 }
 
+/*******************************************************************************/
+// Renders a single block with either 32 or 64 bit samples, depending on the buffer type.
+static void renderSamplesBlock (PlugInInstance* plugInInstance, int blockSize, ARA::ARASamplePosition samplePosition, float* buffer)
+{
+    plugInInstance->renderSamples (blockSize, samplePosition, buffer);
+}
+
+static void renderSamplesBlock (PlugInInstance* plugInInstance, int blockSize, ARA::ARASamplePosition samplePosition, double* buffer)
+{
+    plugInInstance->renderSamples64 (blockSize, samplePosition, buffer);
+}
+
+// Renders the given range of samples in blocks of renderBlockSize on a separate render thread,
+// idling the main thread (after unlocking it if needed) until rendering has completed.
+// Returns the time spent rendering in seconds, measured on the render thread.
+template <typename SampleType>
+static double renderSamplesOnRenderThread (PlugInEntry* plugInEntry, PlugInInstance* plugInInstance, int renderBlockSize,
+                                           ARA::ARASamplePosition startSample, ARA::ARASamplePosition endSample, SampleType* outputData)
+{
+    plugInEntry->unlockDistributedMainThreadIfNeeded ();
+
+    bool renderingCompleted { false };
+    double renderDuration { 0.0 };
+    std::thread renderThread { [&] () {
+        ARAAudioAccessController::registerRenderThread ();
+        const auto startTime { std::chrono::steady_clock::now () };
+        for (auto samplePosition { startSample }; samplePosition < endSample; samplePosition += renderBlockSize)
+        {
+            const auto samplesToRender { std::min (renderBlockSize, static_cast<int> (endSample - samplePosition)) };
+            renderSamplesBlock (plugInInstance, samplesToRender, samplePosition, &outputData[samplePosition - startSample]);
+        }
+        renderDuration = std::chrono::duration<double> (std::chrono::steady_clock::now () - startTime).count ();
+        ARAAudioAccessController::unregisterRenderThread ();
+        renderingCompleted = true;
+    } };
+
+    while (!renderingCompleted)
+        plugInEntry->idleThreadForDuration (10, false);
+
+    renderThread.join ();
+
+    plugInEntry->lockDistributedMainThreadIfNeeded ();
+
+    return renderDuration;
+}
+
 /*******************************************************************************/
 // Demonstrates using a plug-in playback renderer instance to process audio for a playback region,
 // using the companion API rendering methods
@@ -835,31 +918,26 @@ void testPlaybackRendering (PlugInEntry* plugInEntry, bool enableTimeStretchingI
         // render all playback region samples
         plugInInstance->startRendering (renderBlockSize, renderSampleRate);
 
-        bool renderingCompleted { false };
-        auto renderOnOtherThread = [&] () {
-            plugInEntry->unlockDistributedMainThreadIfNeeded ();
+        renderSamplesOnRenderThread (plugInEntry, plugInInstance.get (), renderBlockSize, startOfPlaybackRegionSamples, endOfPlaybackRegionSamples, outputData.data ());
 
-            std::thread renderthread { [&] () {
-                ARAAudioAccessController::registerRenderThread ();
-                for (auto samplePosition { startOfPlaybackRegionSamples }; samplePosition < endOfPlaybackRegionSamples; samplePosition += renderBlockSize)
-                {
-                    const auto samplesToRender { std::min (renderBlockSize, static_cast<int> (endOfPlaybackRegionSamples - samplePosition)) };
-                    const auto outputPosition { samplePosition - startOfPlaybackRegionSamples };
-                    plugInInstance->renderSamples (samplesToRender, samplePosition, &outputData[static_cast<size_t> (outputPosition)]);
-                }
-                ARAAudioAccessController::unregisterRenderThread ();
-                renderingCompleted = true;
-            } };
-
-            while (!renderingCompleted)
-                plugInEntry->idleThreadForDuration (10, false);
-
-            renderthread.join ();
-
-            plugInEntry->lockDistributedMainThreadIfNeeded ();
-        };
-
-        renderOnOtherThread ();
+        // if supported, render again with 64 bit samples and compare against the 32 bit result
+        if (plugInInstance->supports64BitSamples ())
+        {
+            ARA_LOG ("Rendering %lu region(s) assigned to playback renderer %p with 64 bit samples", playbackRegions.size (), playbackRenderer.getRef ());
+
+            std::vector<double> outputData64 (outputData.size ());
+            renderSamplesOnRenderThread (plugInEntry, plugInInstance.get (), renderBlockSize, startOfPlaybackRegionSamples, endOfPlaybackRegionSamples, outputData64.data ());
+
+            // both renders are expected to match within single precision accuracy
+            constexpr double maxAllowedDeviation { 1.0e-5 };
+            double maxDeviation { 0.0 };
+            for (size_t i { 0 }; i < outputData.size (); ++i)
+                maxDeviation = std::max (std::abs (outputData64[i] - static_cast<double> (outputData[i])), maxDeviation);
+            if (maxDeviation <= maxAllowedDeviation)
+                ARA_LOG ("64 bit rendering matches 32 bit rendering (max deviation %lg)", maxDeviation);
+            else
+                ARA_LOG ("64 bit rendering deviates from 32 bit rendering by up to %lg", maxDeviation);
+        }
 
         // optionally perform the render again if the plug-in supports time stretching
         if (enableTimeStretchingIfSupported)
@@ -884,7 +962,7 @@ void testPlaybackRendering (PlugInEntry* plugInEntry, bool enableTimeStretchingI
 
                 ARA_LOG ("Rendering %lu region(s) assigned to playback renderer %p with sample rate %lgHz", playbackRegions.size (), playbackRenderer.getRef (), renderSampleRate);
 
-                renderOnOtherThread ();
+                renderSamplesOnRenderThread (plugInEntry, plugInInstance.get (), renderBlockSize, startOfPlaybackRegionSamples, endOfPlaybackRegionSamples, outputData.data ());
             }
             else
             {
@@ -963,8 +1041,43 @@ void testEditorView (PlugInEntry* plugInEntry, const AudioFileList& audioFiles)
     plugInEntry->unlockDistributedMainThreadIfNeeded ();
 }
 
+/*******************************************************************************/
+// Helper functions to access the environment variables of this process,
+// an empty value indicates that the variable is not set.
+static std::string getEnvironmentVariable (const char* name)
+{
+    std::string result;
+#if defined (_MSC_VER)
+    char* value { nullptr };
+    size_t length { 0 };
+    if ((_dupenv_s (&value, &length, name) == 0) && (value != nullptr))
+    {
+        result = value;
+        std::free (value);
+    }
+#else
+    if (const auto value { std::getenv (name) })
+        result = value;
+#endif
+    return result;
+}
+
+static void setEnvironmentVariable (const char* name, const std::string& value)
+{
+#if defined (_WIN32)
+    _putenv_s (name, value.c_str ());
+#else
+    if (value.empty ())
+        unsetenv (name);
+    else
+        setenv (name, value.c_str (), 1);
+#endif
+}
+
 /*******************************************************************************/
 // Requests plug-in analysis, using every processing algorithm published by the plug-in.
+// Since all algorithms are going to be used, ARATestPlugIn is configured to analyze them in a
+// single pass over the audio, and its I/O is validated accordingly.
 void testProcessingAlgorithms (PlugInEntry* plugInEntry, const AudioFileList& audioFiles)
 {
     ARA_LOG_TEST_HOST_FUNC ("processing algorithms");
@@ -986,6 +1099,22 @@ void testProcessingAlgorithms (PlugInEntry* plugInEntry, const AudioFileList& au
         return;
     }
 
+    // ARATestPlugIn reads this setting whenever starting an analysis - note that remote plug-in
+    // processes only inherit the environment when being launched, so this is ignored when using IPC
+    constexpr auto singlePassAlgorithmsVariable { "ARA_TEST_ANALYSIS_SINGLE_PASS_ALGORITHMS" };
+    const auto previousSinglePassAlgorithms { getEnvironmentVariable (singlePassAlgorithmsVariable) };
+    std::string singlePassAlgorithms;
+    for (auto i { 0 }; i < algorithmCount; ++i)
+    {
+        if (!singlePassAlgorithms.empty ())
+            singlePassAlgorithms += ",";
+        singlePassAlgorithms += araDocumentController->getProcessingAlgorithmProperties (i)->persistentID;
+    }
+    setEnvironmentVariable (singlePassAlgorithmsVariable, singlePassAlgorithms);
+
+    const auto audioAccessController { araDocumentController->getAudioAccessController () };
+    const auto initialReadSampleFrameCount { audioAccessController->getReadSampleFrameCount () };
+
     for (auto i { 0 }; i < algorithmCount; ++i)
     {
         const auto algorithmProperties { araDocumentController->getProcessingAlgorithmProperties (i) };
@@ -997,11 +1126,15 @@ void testProcessingAlgorithms (PlugInEntry* plugInEntry, const AudioFileList& au
             araDocumentController->requestProcessingAlgorithmForAudioSource (audioSource.get (), i);
         araDocumentController->endEditing ();
 
-        // now request analysis for each source and wait for completion
+        // now request analysis for all sources and wait for completion
+        std::vector<AudioSource*> audioSources;
+        for (auto& audioSource : document->getAudioSources ())
+            audioSources.push_back (audioSource.get ());
+        std::function<void (int32_t)> waitFunction { [&] (int32_t milliseconds) { plugInEntry->idleThreadForDuration (milliseconds, true); } };
+        araDocumentController->requestAudioSourcesContentAnalysis (audioSources, araFactory->analyzeableContentTypesCount, araFactory->analyzeableContentTypes, &waitFunction);
+
         for (auto& audioSource : document->getAudioSources ())
         {
-            std::function<void (void)> waitFunction { [&] () { plugInEntry->idleThreadForDuration (50, true); } };
-            araDocumentController->requestAudioSourceContentAnalysis (audioSource.get (), araFactory->analyzeableContentTypesCount, araFactory->analyzeableContentTypes, &waitFunction);
             const auto actualIndex { araDocumentController->getProcessingAlgorithmForAudioSource (audioSource.get ()) };
             if (actualIndex != i)
                 ARA_LOG ("algorithm actually differs from requested algorithm, is %i \"%s\"", actualIndex, araDocumentController->getProcessingAlgorithmProperties (actualIndex)->name);
@@ -1009,6 +1142,193 @@ void testProcessingAlgorithms (PlugInEntry* plugInEntry, const AudioFileList& au
         }
     }
 
+    setEnvironmentVariable (singlePassAlgorithmsVariable, previousSinglePassAlgorithms);
+
+    // ARATestPlugIn reads all samples once to create the fingerprint for its analysis cache, and once more
+    // for analyzing with all algorithms - less if the results have been cached when running previous tests
+    int64_t sampleFrameCount { 0 };
+    for (auto& audioSource : document->getAudioSources ())
+        sampleFrameCount += audioSource->getSampleCount ();
+    const auto readSampleFrameCount { audioAccessController->getReadSampleFrameCount () - initialReadSampleFrameCount };
+    ARA_LOG ("plug-in read %lli sample frames for analyzing %lli sample frames with %i algorithms",
+                static_cast<long long> (readSampleFrameCount), static_cast<long long> (sampleFrameCount), algorithmCount);
+    if (!plugInEntry->usesIPC () && (std::strcmp (araFactory->plugInName, "ARATestPlugIn") == 0))
+        ARA_INTERNAL_ASSERT (readSampleFrameCount <= 2 * sampleFrameCount);
+
+    plugInEntry->unlockDistributedMainThreadIfNeeded ();
+}
+
+/*******************************************************************************/
+// Measures the analysis throughput of every processing algorithm published by the plug-in,
+// in sample frames per second.
+// To make sure the plug-in actually performs the analysis instead of reusing results of previous
+// tests, a dedicated dummy signal is used instead of the provided audio files - note that this
+// cannot prevent reusing results if the plug-in persists analysis results across runs.
+void testAnalysisBenchmark (PlugInEntry* plugInEntry)
+{
+    ARA_LOG_TEST_HOST_FUNC ("analysis benchmark");
+
+    const auto araFactory { plugInEntry->getARAFactory () };
+    if (araFactory->analyzeableContentTypesCount == 0)
+    {
+        ARA_LOG ("No content analysis available for plug-in %s", araFactory->plugInName);
+        return;
+    }
+
+    plugInEntry->lockDistributedMainThreadIfNeeded ();
+
+    // create basic ARA model graph with a single 20 second audio source
+    const AudioFileList benchmarkFiles { std::make_shared<SineAudioFile> ("Benchmark Sin Source", 20.0, 44100.0, 1) };
+    std::unique_ptr<TestHost> testHost;
+    auto araDocumentController { createHostAndBasicDocument (plugInEntry, testHost, "testAnalysisBenchmark", false, benchmarkFiles) };
+    araDocumentController->setMinimalContentUpdateLogging (true);
+    const auto audioSource { araDocumentController->getDocument ()->getAudioSources ().front ().get () };
+
+    // if the plug-in does not publish any processing algorithms, measure its default analysis
+    const auto algorithmCount { std::max (1, araDocumentController->getProcessingAlgorithmsCount ()) };
+    for (auto i { 0 }; i < algorithmCount; ++i)
+    {
+        const char* algorithmName { "default" };
+        if (araDocumentController->getProcessingAlgorithmsCount () > 0)
+        {
+            algorithmName = araDocumentController->getProcessingAlgorithmProperties (i)->name;
+            araDocumentController->beginEditing ();
+            araDocumentController->requestProcessingAlgorithmForAudioSource (audioSource, i);
+            araDocumentController->endEditing ();
+        }
+
+        // use short idle intervals while waiting so that they do not dominate the measurement
+        std::function<void (int32_t)> waitFunction { [&] (int32_t /*milliseconds*/) { plugInEntry->idleThreadForDuration (1, true); } };
+        const auto startTime { std::chrono::steady_clock::now () };
+        araDocumentController->requestAudioSourceContentAnalysis (audioSource, araFactory->analyzeableContentTypesCount, araFactory->analyzeableContentTypes, &waitFunction);
+        const auto duration { std::chrono::duration<double> (std::chrono::steady_clock::now () - startTime).count () };
+
+        const auto sampleCount { audioSource->getSampleCount () };
+        ARA_LOG ("algorithm %i \"%s\": analyzed %lli sample frames in %.3f seconds (%.0f frames per second, %.1fx real-time)",
+                    i, algorithmName, static_cast<long long> (sampleCount), duration,
+                    static_cast<double> (sampleCount) / duration, audioSource->getDuration () / duration);
+    }
+
+    plugInEntry->unlockDistributedMainThreadIfNeeded ();
+}
+
+/*******************************************************************************/
+// Measures CPU load and signal-to-noise ratio of playback rendering at several render sample rates,
+// using a dedicated dummy signal at 44.1 kHz so that the plug-in needs to convert the sample rate.
+// The output is compared against the dummy signal generated directly at the render sample rate,
+// rendering at the audio source sample rate provides a reference for the CPU load without conversion.
+void testResamplingBenchmark (PlugInEntry* plugInEntry)
+{
+    ARA_LOG_TEST_HOST_FUNC ("resampling benchmark");
+
+    plugInEntry->lockDistributedMainThreadIfNeeded ();
+
+    // create basic ARA model graph with a single 10 second audio source
+    constexpr auto sourceSampleRate { 44100.0 };
+    const AudioFileList benchmarkFiles { std::make_shared<SineAudioFile> ("Benchmark Sin Source", 10.0, sourceSampleRate, 1) };
+    std::unique_ptr<TestHost> testHost;
+    auto araDocumentController { createHostAndBasicDocument (plugInEntry, testHost, "testResamplingBenchmark", false, benchmarkFiles) };
+    const auto playbackRegion { araDocumentController->getDocument ()->getRegionSequences ().front ()->getPlaybackRegions ().front () };
+
+    for (const auto renderSampleRate : { sourceSampleRate, 48000.0, 96000.0, 22050.0 })
+    {
+        // instantiate the plug-in with the PlaybackRenderer role and add the playback region
+        auto plugInInstance { plugInEntry->createPlugInInstance () };
+        plugInInstance->bindToDocumentControllerWithRoles (araDocumentController->getDocumentController ()->getRef (), ARA::kARAPlaybackRendererRole);
+        auto playbackRenderer { plugInInstance->getPlaybackRenderer () };
+        playbackRenderer.addPlaybackRegion (araDocumentController->getRef (playbackRegion));
+
+        const auto sampleCount { ARA::samplePositionAtTime (playbackRegion->getEndInPlaybackTime (), renderSampleRate) };
+        std::vector<float> outputData (static_cast<size_t> (sampleCount));
+        constexpr auto renderBlockSize { 2048 };
+        plugInInstance->startRendering (renderBlockSize, renderSampleRate);
+
+        // render on a separate thread, measuring only the rendering itself
+        const auto duration { renderSamplesOnRenderThread (plugInEntry, plugInInstance.get (), renderBlockSize, 0, sampleCount, outputData.data ()) };
+
+        plugInInstance->stopRendering ();
+        playbackRenderer.removePlaybackRegion (araDocumentController->getRef (playbackRegion));
+
+        // compare against the signal generated at the render sample rate
+        std::vector<float> referenceData (static_cast<size_t> (sampleCount));
+        void* const referenceBuffers[] { referenceData.data () };
+        RenderPulsedSineSignal (0, renderSampleRate, sampleCount, 1, sampleCount, referenceBuffers, false);
+        double signalEnergy { 0.0 };
+        double noiseEnergy { 0.0 };
+        for (size_t i { 0 }; i < referenceData.size (); ++i)
+        {
+            const auto difference { static_cast<double> (outputData[i]) - static_cast<double> (referenceData[i]) };
+            signalEnergy += static_cast<double> (referenceData[i]) * static_cast<double> (referenceData[i]);
+            noiseEnergy += difference * difference;
+        }
+        const auto signalToNoiseRatio { (noiseEnergy > 0.0) ? 10.0 * std::log10 (signalEnergy / noiseEnergy) : std::numeric_limits<double>::infinity () };
+
+        ARA_LOG ("%.0f Hz to %.0f Hz: rendered %lli sample frames in %.3f seconds (%.1fx real-time), signal-to-noise ratio %.1f dB",
+                    sourceSampleRate, renderSampleRate, static_cast<long long> (sampleCount), duration,
+                    playbackRegion->getDurationInPlaybackTime () / duration, signalToNoiseRatio);
+    }
+
+    plugInEntry->unlockDistributedMainThreadIfNeeded ();
+}
+
+/*******************************************************************************/
+// Measures the CPU load of playback rendering with several simultaneously playing playback regions
+// that need to be resampled, which plug-ins may render in parallel (e.g. using the host thread pool
+// that the CLAP loader provides to plug-ins supporting the CLAP thread pool extension).
+void testParallelRenderingBenchmark (PlugInEntry* plugInEntry)
+{
+    ARA_LOG_TEST_HOST_FUNC ("parallel rendering benchmark");
+
+    plugInEntry->lockDistributedMainThreadIfNeeded ();
+
+    // create basic ARA model graph with a single 10 second audio source at a sample rate that differs from the render sample rate
+    constexpr auto sourceSampleRate { 48000.0 };
+    constexpr auto renderSampleRate { 44100.0 };
+    const AudioFileList benchmarkFiles { std::make_shared<SineAudioFile> ("Benchmark Sin Source", 10.0, sourceSampleRate, 1) };
+    std::unique_ptr<TestHost> testHost;
+    auto araDocumentController { createHostAndBasicDocument (plugInEntry, testHost, "testParallelRenderingBenchmark", false, benchmarkFiles) };
+    const auto document { araDocumentController->getDocument () };
+    const auto firstPlaybackRegion { document->getRegionSequences ().front ()->getPlaybackRegions ().front () };
+    const auto audioModification { firstPlaybackRegion->getAudioModification () };
+    const auto duration { firstPlaybackRegion->getDurationInPlaybackTime () };
+
+    // add further playback regions for the audio modification on separate tracks, all playing at the same time
+    constexpr auto regionCount { 8 };
+    std::vector<PlaybackRegion*> playbackRegions { firstPlaybackRegion };
+    araDocumentController->beginEditing ();
+    for (auto i { 1 }; i < regionCount; ++i)
+    {
+        auto regionSequence { testHost->addRegionSequence (document, "Track " + std::to_string (i + 1), document->getMusicalContexts ().front ().get (), { 0.0f, 1.0f, 0.0f }) };
+        playbackRegions.push_back (testHost->addPlaybackRegion (document, audioModification, ARA::kARAPlaybackTransformationNoChanges, 0.0, duration, 0.0, duration,
+                                                                regionSequence, "Test playback region " + std::to_string (i + 1), { 0.0f, 0.0f, 1.0f }));
+    }
+    araDocumentController->endEditing ();
+
+    for (const auto renderedRegionCount : { 1, regionCount })
+    {
+        // instantiate the plug-in with the PlaybackRenderer role and add the playback regions
+        auto plugInInstance { plugInEntry->createPlugInInstance () };
+        plugInInstance->bindToDocumentControllerWithRoles (araDocumentController->getDocumentController ()->getRef (), ARA::kARAPlaybackRendererRole);
+        auto playbackRenderer { plugInInstance->getPlaybackRenderer () };
+        for (auto i { 0 }; i < renderedRegionCount; ++i)
+            playbackRenderer.addPlaybackRegion (araDocumentController->getRef (playbackRegions[static_cast<size_t> (i)]));
+
+        const auto sampleCount { ARA::samplePositionAtTime (duration, renderSampleRate) };
+        std::vector<float> outputData (static_cast<size_t> (sampleCount));
+        constexpr auto renderBlockSize { 512 };
+        plugInInstance->startRendering (renderBlockSize, renderSampleRate);
+
+        // render on a separate thread, measuring only the rendering itself
+        const auto renderDuration { renderSamplesOnRenderThread (plugInEntry, plugInInstance.get (), renderBlockSize, 0, sampleCount, outputData.data ()) };
+
+        plugInInstance->stopRendering ();
+        for (auto i { 0 }; i < renderedRegionCount; ++i)
+            playbackRenderer.removePlaybackRegion (araDocumentController->getRef (playbackRegions[static_cast<size_t> (i)]));
+
+        ARA_LOG ("%i playback region(s): rendered %lli sample frames in %.3f seconds (%.1fx real-time)",
+                    renderedRegionCount, static_cast<long long> (sampleCount), renderDuration, duration / renderDuration);
+    }
+
     plugInEntry->unlockDistributedMainThreadIfNeeded ();
 }
 
@@ -71,6 +71,18 @@ void testEditorView (PlugInEntry* plugInEntry, const AudioFileList& audioFiles);
 // Requests plug-in analysis, using every processing algorithm published by the plug-in.
 void testProcessingAlgorithms (PlugInEntry* plugInEntry, const AudioFileList& audioFiles);
 
+// Measures the analysis throughput of every processing algorithm published by the plug-in
+// using a dedicated dummy signal, logging sample frames analyzed per second
+void testAnalysisBenchmark (PlugInEntry* plugInEntry);
+
+// Measures CPU load and signal-to-noise ratio of playback rendering when the render sample rate
+// differs from the audio source sample rate, using a dedicated dummy signal
+void testResamplingBenchmark (PlugInEntry* plugInEntry);
+
+// Measures CPU load of playback rendering with several simultaneously playing playback regions,
+// which plug-ins may render in parallel, using a dedicated dummy signal
+void testParallelRenderingBenchmark (PlugInEntry* plugInEntry);
+
 // Loads an `iXML` ARA audio file chunk from a supplied .WAV or .AIFF file
 void testAudioFileChunkLoading (PlugInEntry* plugInEntry, const AudioFileList& audioFiles);
 
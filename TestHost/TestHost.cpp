@@ -119,6 +119,11 @@ AudioSource* TestHost::addAudioSource (Document* document, AudioFileBase* audioF
 
 void TestHost::removeAudioSource (Document* document, AudioSource* audioSource)
 {
+    const auto blockCacheStatistics { audioSource->getBlockCache ().getStatistics () };
+    if (blockCacheStatistics.hitCount + blockCacheStatistics.missCount > 0)
+        ARA_LOG ("audio source %p block cache: %llu hits, %llu misses", audioSource,
+                    static_cast<unsigned long long> (blockCacheStatistics.hitCount), static_cast<unsigned long long> (blockCacheStatistics.missCount));
+
     if (auto araDocumentController = getDocumentController (document))
         araDocumentController->removeAudioSource (audioSource);
     document->removeAudioSource (audioSource);
@@ -36,7 +36,9 @@
 // The macOS version also supports running the plug-in in a separate process, connected via IPC,
 // by specifying `-ipc_vst3` or `-ipc_au` or `-ipc_clap` instead of `-vst3` or `-au` or `-clap`.
 //
-// If the optional `-test` argument is not supplied, all test cases will be run.
+// If the optional `-test` argument is not supplied, all test cases will be run, except for the
+// benchmarks (AnalysisBenchmark, ResamplingBenchmark, ParallelRenderingBenchmark), which take
+// considerably longer and thus only run if explicitly listed.
 // See implementation of main() at the end of this file for a list of available test cases.
 //
 // If the optional `-file` argument is not supplied, a pulsed sine wave will be generated in-memory.
@@ -213,6 +215,7 @@ int main (int argc, const char* argv[])
 
     // conditionally execute each test case
     const auto shouldTest { [&] (const std::string& testCase) { return testCases.empty () || ARA::contains (testCases, testCase); } };
+    const auto shouldBenchmark { [&] (const std::string& testCase) { return ARA::contains (testCases, testCase); } };
     if (shouldTest ("PropertyUpdates"))
         testPropertyUpdates (plugInEntry.get (), audioFiles);
     if (shouldTest ("ContentUpdates"))
@@ -233,6 +236,12 @@ int main (int argc, const char* argv[])
         testEditorView (plugInEntry.get (), audioFiles);
     if (shouldTest ("Algorithms"))
         testProcessingAlgorithms (plugInEntry.get (), audioFiles);
+    if (shouldBenchmark ("AnalysisBenchmark"))
+        testAnalysisBenchmark (plugInEntry.get ());
+    if (shouldBenchmark ("ResamplingBenchmark"))
+        testResamplingBenchmark (plugInEntry.get ());
+    if (shouldBenchmark ("ParallelRenderingBenchmark"))
+        testParallelRenderingBenchmark (plugInEntry.get ());
     if (shouldTest ("AudioFileChunkSaving"))
         testAudioFileChunkSaving (plugInEntry.get (), audioFiles);
     if (shouldTest ("AudioFileChunkLoading"))
@@ -19,11 +19,49 @@
 
 #include "ARATestAudioSource.h"
 
+#include <algorithm>
 #include <cmath>
 
 void ARATestAudioSource::setNoteContent (std::unique_ptr<TestNoteContent>&& analysisResult, ARA::ARAContentGrade grade, bool fromHost) noexcept
 {
     _noteContent = std::move (analysisResult);
+    _exportedNoteContent.reset ();
+    if (_noteContent)
+    {
+        auto exportedNoteContent { std::make_shared<ExportedNoteContent> () };
+        exportedNoteContent->_notes.reserve (_noteContent->size ());
+        for (const auto& note : *_noteContent)
+        {
+            ARA::ARAContentNote exportedNote;
+            exportedNote.frequency = note._frequency;
+            if (exportedNote.frequency == ARA::kARAInvalidFrequency)
+                exportedNote.pitchNumber = ARA::kARAInvalidPitchNumber;
+            else
+                exportedNote.pitchNumber = static_cast<ARA::ARAPitchNumber> (floor (0.5f + 69.0f + 12.0f * logf (exportedNote.frequency / 440.0f) / logf (2.0f)));
+            exportedNote.volume = note._volume;
+            exportedNote.startPosition = note._startTime;
+            exportedNote.attackDuration = 0.0;
+            exportedNote.noteDuration = note._duration;
+            exportedNote.signalDuration = note._duration;
+            exportedNoteContent->_notes.emplace_back (exportedNote);
+        }
+
+        // our analysis creates the notes in order, but notes read from the host may be unsorted
+        auto& notes { exportedNoteContent->_notes };
+        const auto isNoteBefore { [] (const ARA::ARAContentNote& a, const ARA::ARAContentNote& b) { return a.startPosition < b.startPosition; } };
+        if (!std::is_sorted (notes.begin (), notes.end (), isNoteBefore))
+            std::stable_sort (notes.begin (), notes.end (), isNoteBefore);
+
+        auto& maxEndPositions { exportedNoteContent->_maxEndPositions };
+        maxEndPositions.reserve (notes.size ());
+        for (const auto& note : notes)
+        {
+            const auto endPosition { note.startPosition + note.noteDuration };
+            maxEndPositions.emplace_back ((maxEndPositions.empty ()) ? endPosition : std::max (maxEndPositions.back (), endPosition));
+        }
+
+        _exportedNoteContent = std::move (exportedNoteContent);
+    }
     _noteContentGrade = grade;
     _noteContentWasReadFromHost = fromHost;
 }
@@ -33,27 +71,54 @@ void ARATestAudioSource::updateRenderSampleCache ()
     ARA_INTERNAL_ASSERT (isSampleAccessEnabled ());
 
     // set up cache (this is a hack, so we're ignoring potential overflow of 32 bit with long files here...)
+    // only the cache matching the current sample precision is kept, the other one is released
     const auto channelCount { static_cast<size_t> (getChannelCount ()) };
     const auto sampleCount { static_cast<size_t> (getSampleCount ()) };
-    _sampleCache.resize (channelCount * sampleCount);
+    _isRenderSampleCacheDoublePrecision = merits64BitSamples ();
+    if (_isRenderSampleCacheDoublePrecision)
+    {
+        std::vector<float> {}.swap (_sampleCache);
+        _sampleCache64.resize (channelCount * sampleCount);
+    }
+    else
+    {
+        std::vector<double> {}.swap (_sampleCache64);
+        _sampleCache.resize (channelCount * sampleCount);
+    }
 
     // create temporary host audio reader and let it fill the cache
     // (we can safely ignore any errors while reading since host must clear buffers in that case,
     // as well as report the error to the user)
-    ARA::PlugIn::HostAudioReader audioReader { this };
+    ARA::PlugIn::HostAudioReader audioReader { this, _isRenderSampleCacheDoublePrecision };
     std::vector<void*> dataPointers { channelCount };
     for (auto c { 0U }; c < channelCount; ++c)
-        dataPointers[c] = _sampleCache.data () + c * sampleCount;
+    {
+        if (_isRenderSampleCacheDoublePrecision)
+            dataPointers[c] = _sampleCache64.data () + c * sampleCount;
+        else
+            dataPointers[c] = _sampleCache.data () + c * sampleCount;
+    }
     audioReader.readAudioSamples (0, static_cast<ARA::ARASampleCount> (sampleCount), dataPointers.data ());
 }
 
-const float* ARATestAudioSource::getRenderSampleCacheForChannel (ARA::ARAChannelCount channel) const
+template <>
+const float* ARATestAudioSource::getRenderSampleCacheForChannel<float> (ARA::ARAChannelCount channel) const
 {
+    ARA_INTERNAL_ASSERT (!_isRenderSampleCacheDoublePrecision);
     return _sampleCache.data () + static_cast<size_t> (channel * getSampleCount ());
 }
 
+template <>
+const double* ARATestAudioSource::getRenderSampleCacheForChannel<double> (ARA::ARAChannelCount channel) const
+{
+    ARA_INTERNAL_ASSERT (_isRenderSampleCacheDoublePrecision);
+    return _sampleCache64.data () + static_cast<size_t> (channel * getSampleCount ());
+}
+
 void ARATestAudioSource::destroyRenderSampleCache ()
 {
     _sampleCache.clear ();
     _sampleCache.resize (0);
+    _sampleCache64.clear ();
+    _sampleCache64.resize (0);
 }
@@ -23,6 +23,8 @@
 
 #include "TestAnalysis.h"
 
+#include <memory>
+
 /*******************************************************************************/
 class ARATestAudioSource : public ARA::PlugIn::AudioSource
 {
@@ -42,21 +44,54 @@ public:
     void setNoteContent (std::unique_ptr<TestNoteContent>&& analysisResult, ARA::ARAContentGrade grade, bool fromHost) noexcept;
     void clearNoteContent () noexcept { return setNoteContent ({}, ARA::kARAContentGradeInitial, false); }
 
+    // the analysis cache key of the last full analysis, which allows for looking up results for other
+    // algorithms without reading all samples again - must be reset by the document controller whenever
+    // the samples change, may return nullptr if not available
+    const TestAnalysisCacheKey* getAnalysisCacheKey () const noexcept { return _analysisCacheKey.get (); }
+    void setAnalysisCacheKey (const TestAnalysisCacheKey& key) { _analysisCacheKey = std::make_unique<TestAnalysisCacheKey> (key); }
+    void clearAnalysisCacheKey () noexcept { _analysisCacheKey.reset (); }
+
+    // ARA representation of the note content, converted once when the content is set and sorted by
+    // start position. The running maximum of the note end positions allows for binary searching all
+    // notes that intersect a given time range. Content readers share ownership of this data so that
+    // they remain valid if the note content is replaced while they are still in use.
+    struct ExportedNoteContent
+    {
+        std::vector<ARA::ARAContentNote> _notes;
+        std::vector<ARA::ARATimePosition> _maxEndPositions;
+    };
+    // may return nullptr if analysis has not completed yet
+    const std::shared_ptr<const ExportedNoteContent>& getExportedNoteContent () const noexcept { return _exportedNoteContent; }
+
     // render thread sample access:
     // in order to keep this test code as simple as possible, our test audio source uses brute
     // force and caches all samples in-memory so that renderers can access it without threading issues
     // the document controller triggers filling this cache on the main thread, immediately after access is enabled.
     // actual plug-ins will use a multi-threaded setup to only cache sections of the audio source on demand -
     // a sophisticated file I/O threading implementation is needed for file-based processing regardless of ARA.
+    // if the host indicates that the audio source merits 64 bit samples, the cache is filled with doubles
+    // so that double precision renderers can access the samples without loss, otherwise it uses floats.
     void updateRenderSampleCache ();
-    const float* getRenderSampleCacheForChannel (ARA::ARAChannelCount channel) const;
+    bool isRenderSampleCacheDoublePrecision () const noexcept { return _isRenderSampleCacheDoublePrecision; }
+    // SampleType must be double if isRenderSampleCacheDoublePrecision (), float otherwise
+    template <typename SampleType>
+    const SampleType* getRenderSampleCacheForChannel (ARA::ARAChannelCount channel) const;
     void destroyRenderSampleCache ();
 
 protected:
     const TestProcessingAlgorithm* _processingAlgorithm;
     std::unique_ptr<TestNoteContent> _noteContent;
+    std::shared_ptr<const ExportedNoteContent> _exportedNoteContent;
     ARA::ARAContentGrade _noteContentGrade { ARA::kARAContentGradeInitial };
     bool _noteContentWasReadFromHost { false };
+    std::unique_ptr<TestAnalysisCacheKey> _analysisCacheKey;
 
     std::vector<float> _sampleCache;
+    std::vector<double> _sampleCache64;
+    bool _isRenderSampleCacheDoublePrecision { false };
 };
+
+template <>
+const float* ARATestAudioSource::getRenderSampleCacheForChannel<float> (ARA::ARAChannelCount channel) const;
+template <>
+const double* ARATestAudioSource::getRenderSampleCacheForChannel<double> (ARA::ARAChannelCount channel) const;
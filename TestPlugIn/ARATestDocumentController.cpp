@@ -26,11 +26,15 @@
 #include "ExamplesCommon/Utilities/StdUniquePtrUtilities.h"
 
 #include "ARA_Library/Debug/ARAContentLogger.h"
+#include "ARA_Library/Utilities/ARASamplePositionConversion.h"
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <map>
 #include <atomic>
 #include <future>
+#include <mutex>
 
 #if defined (__APPLE__)
     #include <dispatch/dispatch.h>
@@ -52,32 +56,15 @@ ARA_SETUP_DEBUG_MESSAGE_PREFIX (TEST_PLUGIN_NAME);
 /*******************************************************************************/
 
 // subclass of the SDK's content reader class to export our detected notes
+// The reader is a lightweight view onto the notes cached by the audio source: creating it only
+// requires two binary searches to determine the range of notes relevant for the requested time range.
+// Note that according to the ARA API, the reader may include some notes that do not intersect the range.
 class ARATestNoteContentReader : public ARA::PlugIn::ContentReader
 {
 public:
     explicit ARATestNoteContentReader (const ARATestAudioSource* audioSource, const ARA::ARAContentTimeRange* range)
     {
-        ARA_INTERNAL_ASSERT (audioSource->getNoteContent () != nullptr);
-        for (const auto& note : *audioSource->getNoteContent ())
-        {
-            // skip note if it does not intersect with the time range
-            if (range && ((note._startTime + note._duration <= range->start) ||
-                          (range->start + range->duration <= note._startTime)))
-                continue;
-
-            ARA::ARAContentNote exportedNote;
-            exportedNote.frequency = note._frequency;
-            if (exportedNote.frequency == ARA::kARAInvalidFrequency)
-                exportedNote.pitchNumber = ARA::kARAInvalidPitchNumber;
-            else
-                exportedNote.pitchNumber = static_cast<ARA::ARAPitchNumber> (floor (0.5f + 69.0f + 12.0f * logf (exportedNote.frequency / 440.0f) / logf (2.0f)));
-            exportedNote.volume = note._volume;
-            exportedNote.startPosition = note._startTime;
-            exportedNote.attackDuration = 0.0;
-            exportedNote.noteDuration = note._duration;
-            exportedNote.signalDuration = note._duration;
-            _exportedNotes.emplace_back (exportedNote);
-        }
+        initializeNoteRange (audioSource, range);
     }
 
     // since our test plug-in makes no modifications to the audio source, it can simply forward the content reading to the source
@@ -85,35 +72,74 @@ public:
     : ARATestNoteContentReader { audioModification->getAudioSource<ARATestAudioSource> (), range }
     {}
 
-    // since our test plug-in directly plays sections from the audio modification without any time stretching or other adoption,
-    // it can simply copy the modification content and adjust it (and the optional filter range) to the actual playback position
+    // since our test plug-in plays sections from the audio modification either as is or linearly time stretched,
+    // it can simply use the modification content and map it (and the optional filter range) to the actual playback time
     explicit ARATestNoteContentReader (const ARA::PlugIn::PlaybackRegion* playbackRegion, const ARA::ARAContentTimeRange* range)
+    : _startInModificationTime { playbackRegion->getStartInAudioModificationTime () },
+      _startInPlaybackTime { playbackRegion->getStartInPlaybackTime () },
+      _timeScale { getTimeScale (playbackRegion) }
     {
-        // get filtered notes in modification time via a temporary modification reader
-        const auto timeOffset { playbackRegion->getStartInPlaybackTime () - playbackRegion->getStartInAudioModificationTime () };
-        const ARA::ARAContentTimeRange modificationRange { (range) ? range->start - timeOffset : playbackRegion->getStartInAudioModificationTime (),
-                                                           (range) ? range->start - timeOffset : playbackRegion->getDurationInAudioModificationTime () };
-        ARATestNoteContentReader tempModificationReader { playbackRegion->getAudioModification (), &modificationRange };
-
-        // swap content with temp reader and adjust note starts from modification time to playback time
-        _exportedNotes.swap (tempModificationReader._exportedNotes);
-        for (auto& exportedNote : _exportedNotes)
-            exportedNote.startPosition += timeOffset;
+        const ARA::ARAContentTimeRange modificationRange { (range) ? _startInModificationTime + (range->start - _startInPlaybackTime) / _timeScale : _startInModificationTime,
+                                                           (range) ? range->duration / _timeScale : playbackRegion->getDurationInAudioModificationTime () };
+        initializeNoteRange (playbackRegion->getAudioModification ()->getAudioSource<ARATestAudioSource> (), &modificationRange);
     }
 
     ARA::ARAInt32 getEventCount () noexcept override
     {
-        return static_cast<ARA::ARAInt32> (_exportedNotes.size ());
-
+        return static_cast<ARA::ARAInt32> (_endIndex - _beginIndex);
     }
 
     const void* getDataForEvent (ARA::ARAInt32 eventIndex) noexcept override
     {
-        return &_exportedNotes[static_cast<size_t> (eventIndex)];
+        const auto& exportedNote { _exportedNoteContent->_notes[_beginIndex + static_cast<size_t> (eventIndex)] };
+        if ((_startInModificationTime == _startInPlaybackTime) && (_timeScale == 1.0))
+            return &exportedNote;
+
+        // the returned data only needs to remain valid until the next call to the reader,
+        // so we can map notes from modification time to playback time on the fly
+        _adjustedNote = exportedNote;
+        _adjustedNote.startPosition = _startInPlaybackTime + (exportedNote.startPosition - _startInModificationTime) * _timeScale;
+        _adjustedNote.attackDuration *= _timeScale;
+        _adjustedNote.noteDuration *= _timeScale;
+        _adjustedNote.signalDuration *= _timeScale;
+        return &_adjustedNote;
+    }
+
+private:
+    static double getTimeScale (const ARA::PlugIn::PlaybackRegion* playbackRegion)
+    {
+        if (!playbackRegion->isTimestretchEnabled () || (playbackRegion->getDurationInAudioModificationTime () <= 0.0))
+            return 1.0;
+        return playbackRegion->getDurationInPlaybackTime () / playbackRegion->getDurationInAudioModificationTime ();
+    }
+
+    void initializeNoteRange (const ARATestAudioSource* audioSource, const ARA::ARAContentTimeRange* range)
+    {
+        _exportedNoteContent = audioSource->getExportedNoteContent ();
+        ARA_INTERNAL_ASSERT (_exportedNoteContent != nullptr);
+
+        const auto& notes { _exportedNoteContent->_notes };
+        if (!range)
+        {
+            _endIndex = notes.size ();
+            return;
+        }
+
+        // skip all notes that end before the range, then all notes that start after it
+        const auto& maxEndPositions { _exportedNoteContent->_maxEndPositions };
+        _beginIndex = static_cast<size_t> (std::upper_bound (maxEndPositions.begin (), maxEndPositions.end (), range->start) - maxEndPositions.begin ());
+        _endIndex = static_cast<size_t> (std::lower_bound (notes.begin () + static_cast<ptrdiff_t> (_beginIndex), notes.end (), range->start + range->duration,
+                                                           [] (const ARA::ARAContentNote& note, ARA::ARATimePosition position) { return note.startPosition < position; } ) - notes.begin ());
     }
 
 private:
-    std::vector<ARA::ARAContentNote> _exportedNotes;
+    std::shared_ptr<const ARATestAudioSource::ExportedNoteContent> _exportedNoteContent;
+    size_t _beginIndex { 0 };
+    size_t _endIndex { 0 };
+    const ARA::ARATimePosition _startInModificationTime { 0.0 };
+    const ARA::ARATimePosition _startInPlaybackTime { 0.0 };
+    const double _timeScale { 1.0 };    // playback duration per modification duration
+    ARA::ARAContentNote _adjustedNote {};
 };
 
 /*******************************************************************************/
@@ -216,19 +242,86 @@ private:
 
 /*******************************************************************************/
 
+// Our algorithms report progress after each block, but each progress notification may be logged by
+// the host or (when using IPC) be sent as a blocking message, so they are coalesced to at most
+// about 30 notifications per second with a minimum step of 1%.
+constexpr std::chrono::milliseconds minProgressNotificationInterval { 33 };
+constexpr float minProgressNotificationDelta { 0.01f };
+
 class ARATestAnalysisTask : public TestAnalysisCallbacks
 {
 public:
-    explicit ARATestAnalysisTask (ARATestAudioSource* audioSource, const TestProcessingAlgorithm* processingAlgorithm)
+    // if previousNoteContent is provided, only the changedSampleRange will be re-analyzed
+    // otherwise, the analysis cache is checked first and updated with the analysis result
+    explicit ARATestAnalysisTask (ARATestAudioSource* audioSource, const TestProcessingAlgorithm* processingAlgorithm,
+                                  const TestNoteContent* previousNoteContent = nullptr, std::pair<int64_t, int64_t> changedSampleRange = {})
     : _audioSource { audioSource },
       _hostAudioReader { std::make_unique<ARA::PlugIn::HostAudioReader> (audioSource) },    // create audio reader on the main thread, before dispatching to analysis thread
-      _processingAlgorithm { processingAlgorithm }
+      _processingAlgorithm { processingAlgorithm },
+      _previousNoteContent { (previousNoteContent) ? std::make_unique<TestNoteContent> (*previousNoteContent) : nullptr },
+      _changedSampleRange { changedSampleRange },
+      _analyzedSampleRange { changedSampleRange }
     {
+        // for full analyses, reuse the fingerprint of a previous analysis if the samples have not changed since,
+        // and determine the algorithms to analyze in the same pass (on the main thread, where the configuration is read)
+        if (!_previousNoteContent)
+        {
+            if (const auto cacheKey { audioSource->getAnalysisCacheKey () })
+            {
+                _isCacheable = true;
+                _cacheKey = *cacheKey;
+                _cacheKey._algorithmIdentifier = processingAlgorithm->getIdentifier ();
+            }
+
+            const auto singlePassAlgorithms { TestProcessingAlgorithm::getSinglePassAlgorithms () };
+            if (ARA::contains (singlePassAlgorithms, processingAlgorithm))
+            {
+                for (const auto algorithm : singlePassAlgorithms)
+                {
+                    if (algorithm != processingAlgorithm)
+                        _singlePassAlgorithms.push_back (algorithm);
+                }
+            }
+        }
+
         _future = std::async (std::launch::async, [this] ()
         {
-            if (auto newNoteContent = _processingAlgorithm->analyzeNoteContent (this, _audioSource->getSampleCount (), _audioSource->getSampleRate (),
-                                                                                static_cast<uint32_t> (_audioSource->getChannelCount ())))
+            const auto sampleCount { _audioSource->getSampleCount () };
+            const auto sampleRate { _audioSource->getSampleRate () };
+            const auto channelCount { static_cast<uint32_t> (_audioSource->getChannelCount ()) };
+            std::unique_ptr<TestNoteContent> newNoteContent;
+            if (_previousNoteContent)
+            {
+                // results of partial re-analysis are not cached: the fingerprint requires reading all samples,
+                // which would defeat the purpose of only re-analyzing the changed samples
+                newNoteContent = _processingAlgorithm->reanalyzeNoteContent (this, sampleCount, sampleRate, channelCount, *_previousNoteContent,
+                                                                             _analyzedSampleRange.first, _analyzedSampleRange.second);
+            }
+            else
+            {
+                // if the same audio has been analyzed before, e.g. in a different document, we can use the cached result
+                // (the fingerprint requires reading all samples, so it is created here instead of on the main thread)
+                if (!_isCacheable)
+                    _isCacheable = TestAnalysisCache::createKey (this, sampleCount, sampleRate, channelCount, _processingAlgorithm, _cacheKey);
+                if (_isCacheable)
+                    newNoteContent = TestAnalysisCache::getNoteContent (_cacheKey);
+
+                if (!newNoteContent)
+                {
+                    if (_isCacheable && !_singlePassAlgorithms.empty ())
+                        newNoteContent = analyzeNoteContentInSinglePass (sampleCount, sampleRate, channelCount);
+                    else
+                        newNoteContent = _processingAlgorithm->analyzeNoteContent (this, sampleCount, sampleRate, channelCount);
+
+                    if (newNoteContent && _isCacheable)
+                        TestAnalysisCache::storeNoteContent (_cacheKey, *newNoteContent);
+                }
+            }
+
+            if (newNoteContent)
                 _noteContent = std::move (newNoteContent);
+
+            _audioSource->getDocumentController<ARATestDocumentController> ()->enqueueCompletedAnalysisTask (this);
         });
     }
 
@@ -242,11 +335,40 @@ public:
         return _processingAlgorithm;
     }
 
+    bool isPartialAnalysis () const noexcept
+    {
+        return _previousNoteContent != nullptr;
+    }
+
+    // returns nullptr if the result could not be cached, only valid after the task is done
+    const TestAnalysisCacheKey* getCacheKey () const noexcept
+    {
+        ARA_INTERNAL_ASSERT (isDone ());
+        return (_isCacheable) ? &_cacheKey : nullptr;
+    }
+
+    const std::pair<int64_t, int64_t>& getChangedSampleRange () const noexcept
+    {
+        return _changedSampleRange;
+    }
+
+    // the algorithm may need to extend the changed range, so this is only valid after the task is done
+    const std::pair<int64_t, int64_t>& getAnalyzedSampleRange () const noexcept
+    {
+        ARA_INTERNAL_ASSERT (isDone ());
+        return _analyzedSampleRange;
+    }
+
     bool isDone () const
     {
         return _future.wait_for (std::chrono::milliseconds { 0 }) == std::future_status::ready;
     }
 
+    void waitUntilDone () const
+    {
+        _future.wait ();
+    }
+
     void cancelSynchronously ()
     {
         _shouldCancel = true;
@@ -262,11 +384,22 @@ public:
 
     void notifyAnalysisProgressStarted () noexcept
     {
+        _lastNotifiedProgress = 0.0f;
+        _lastProgressNotificationTime = std::chrono::steady_clock::now ();
         _audioSource->getDocumentController ()->notifyAudioSourceAnalysisProgressStarted (_audioSource);
     }
 
+    // completion is always notified separately, so updates can safely be dropped here
     void notifyAnalysisProgressUpdated (float progress) noexcept
     {
+        if (progress - _lastNotifiedProgress < minProgressNotificationDelta)
+            return;
+        const auto now { std::chrono::steady_clock::now () };
+        if (now - _lastProgressNotificationTime < minProgressNotificationInterval)
+            return;
+
+        _lastNotifiedProgress = progress;
+        _lastProgressNotificationTime = now;
         _audioSource->getDocumentController ()->notifyAudioSourceAnalysisProgressUpdated (_audioSource, progress);
     }
 
@@ -286,12 +419,49 @@ public:
     }
 
 private:
+    // analyzes with the requested algorithm and all configured single-pass algorithms that are not cached yet
+    // in a single pass over the audio, storing the results of the other algorithms in the cache so that
+    // switching to one of them later on does not require reading the audio again
+    std::unique_ptr<TestNoteContent> analyzeNoteContentInSinglePass (int64_t sampleCount, double sampleRate, uint32_t channelCount)
+    {
+        std::vector<const TestProcessingAlgorithm*> algorithms { _processingAlgorithm };
+        std::vector<TestAnalysisCacheKey> cacheKeys { _cacheKey };
+        for (const auto algorithm : _singlePassAlgorithms)
+        {
+            auto cacheKey { _cacheKey };
+            cacheKey._algorithmIdentifier = algorithm->getIdentifier ();
+            if (TestAnalysisCache::hasNoteContent (cacheKey))
+                continue;
+            algorithms.push_back (algorithm);
+            cacheKeys.emplace_back (std::move (cacheKey));
+        }
+
+        auto results { TestProcessingAlgorithm::analyzeNoteContentWithAlgorithms (algorithms, this, sampleCount, sampleRate, channelCount) };
+        if (shouldCancel ())
+            return nullptr;
+
+        for (size_t i { 1 }; i < results.size (); ++i)
+        {
+            if (results[i])
+                TestAnalysisCache::storeNoteContent (cacheKeys[i], *results[i]);
+        }
+        return std::move (results.front ());
+    }
+
     ARATestAudioSource* const _audioSource;
     const std::unique_ptr<ARA::PlugIn::HostAudioReader> _hostAudioReader;
     const TestProcessingAlgorithm* const _processingAlgorithm;
+    bool _isCacheable { false };            // set up on the main thread if the fingerprint is known, otherwise on the analysis thread
+    TestAnalysisCacheKey _cacheKey;
+    std::vector<const TestProcessingAlgorithm*> _singlePassAlgorithms;
+    const std::unique_ptr<TestNoteContent> _previousNoteContent;
+    const std::pair<int64_t, int64_t> _changedSampleRange;
+    std::pair<int64_t, int64_t> _analyzedSampleRange;
     std::unique_ptr<TestNoteContent> _noteContent;
     std::future<void> _future;
     std::atomic<bool> _shouldCancel { false };
+    float _lastNotifiedProgress { 0.0f };
+    std::chrono::steady_clock::time_point _lastProgressNotificationTime;
 };
 
 /*******************************************************************************/
@@ -302,6 +472,9 @@ void ARATestDocumentController::startOrScheduleAnalysisOfAudioSource (ARATestAud
     if (getActiveAnalysisTaskForAudioSource (audioSource) != nullptr)
         return;
 
+    // any pending partial re-analysis will be covered by the full analysis
+    _audioSourcesScheduledForReanalysis.erase (audioSource);
+
     // postpone if host is currently editing or access is not enabled yet, otherwise start immediately
     if (isHostEditingDocument () || !audioSource->isSampleAccessEnabled ())
     {
@@ -316,18 +489,33 @@ void ARATestDocumentController::startOrScheduleAnalysisOfAudioSource (ARATestAud
 
 bool ARATestDocumentController::cancelAnalysisOfAudioSource (ARATestAudioSource* audioSource)
 {
+    const bool wasScheduledForReanalysis { _audioSourcesScheduledForReanalysis.erase (audioSource) != 0 };
+
     if (cancelAnalysisTaskForAudioSource (audioSource))
         return true;
 
-    return _audioSourcesScheduledForAnalysis.erase (audioSource) != 0;
+    return (_audioSourcesScheduledForAnalysis.erase (audioSource) != 0) || wasScheduledForReanalysis;
 }
 
-void ARATestDocumentController::startAnalysisTaskForAudioSource (ARATestAudioSource* audioSource)
+void ARATestDocumentController::startAnalysisTaskForAudioSource (ARATestAudioSource* audioSource, const std::pair<int64_t, int64_t>* changedSampleRange)
 {
     ARA_INTERNAL_ASSERT (audioSource->isSampleAccessEnabled ());
 
+    // a full analysis supersedes any pending partial re-analysis
+    if (!changedSampleRange)
+        _audioSourcesScheduledForReanalysis.erase (audioSource);
+
     const auto algorithm = audioSource->getProcessingAlgorithm ();
-    _activeAnalysisTasks.emplace_back (std::make_unique<ARATestAnalysisTask> (audioSource, algorithm));
+
+    if (changedSampleRange)
+    {
+        ARA_INTERNAL_ASSERT (audioSource->getNoteContent () != nullptr);
+        _activeAnalysisTasks.emplace_back (std::make_unique<ARATestAnalysisTask> (audioSource, algorithm, audioSource->getNoteContent (), *changedSampleRange));
+    }
+    else
+    {
+        _activeAnalysisTasks.emplace_back (std::make_unique<ARATestAnalysisTask> (audioSource, algorithm));
+    }
 }
 
 bool ARATestDocumentController::cancelAnalysisTaskForAudioSource (ARATestAudioSource* audioSource)
@@ -335,6 +523,11 @@ bool ARATestDocumentController::cancelAnalysisTaskForAudioSource (ARATestAudioSo
     if (ARATestAnalysisTask* analysisTask { getActiveAnalysisTaskForAudioSource (audioSource) })
     {
         analysisTask->cancelSynchronously ();
+        {
+            // the task has already enqueued itself upon completing, so we must remove it from the queue
+            std::lock_guard<std::mutex> lock { _completedAnalysisTasksMutex };
+            _completedAnalysisTasks.erase (std::remove (_completedAnalysisTasks.begin (), _completedAnalysisTasks.end (), analysisTask), _completedAnalysisTasks.end ());
+        }
         ARA::find_erase (_activeAnalysisTasks, analysisTask);
         return true;
     }
@@ -352,28 +545,62 @@ ARATestAnalysisTask* ARATestDocumentController::getActiveAnalysisTaskForAudioSou
     return nullptr;
 }
 
+void ARATestDocumentController::enqueueCompletedAnalysisTask (ARATestAnalysisTask* analysisTask)
+{
+    std::lock_guard<std::mutex> lock { _completedAnalysisTasksMutex };
+    _completedAnalysisTasks.push_back (analysisTask);
+}
+
 void ARATestDocumentController::processCompletedAnalysisTasks ()
 {
-    auto analysisTaskIt { _activeAnalysisTasks.begin () };
-    while (analysisTaskIt != _activeAnalysisTasks.end ())
+    std::vector<ARATestAnalysisTask*> completedAnalysisTasks;
+    {
+        std::lock_guard<std::mutex> lock { _completedAnalysisTasksMutex };
+        if (_completedAnalysisTasks.empty ())
+            return;
+        completedAnalysisTasks.swap (_completedAnalysisTasks);
+    }
+
+    for (auto analysisTask : completedAnalysisTasks)
     {
-        if (!(*analysisTaskIt)->isDone ())
+        // tasks enqueue themselves right before their worker returns, so this will not block noticeably
+        analysisTask->waitUntilDone ();
+
+        // remember the fingerprint so that later analyses with other algorithms can check the cache without reading the samples
+        if (!analysisTask->isPartialAnalysis ())
         {
-            ++analysisTaskIt;
-            continue;
+            if (const auto cacheKey { analysisTask->getCacheKey () })
+                analysisTask->getAudioSource ()->setAnalysisCacheKey (*cacheKey);
         }
 
-        if (auto&& noteContent { (*analysisTaskIt)->transferNoteContent () })
+        if (auto&& noteContent { analysisTask->transferNoteContent () })
         {
-            auto audioSource { (*analysisTaskIt)->getAudioSource () };
-            const auto algorithm { (*analysisTaskIt)->getProcessingAlgorithm () };
+            auto audioSource { analysisTask->getAudioSource () };
+            const auto algorithm { analysisTask->getProcessingAlgorithm () };
             audioSource->setProcessingAlgorithm (algorithm);
             audioSource->setNoteContent (std::move (noteContent), ARA::kARAContentGradeDetected, false);
-            notifyAudioSourceContentChanged (audioSource, ARA::ContentUpdateScopes::notesAreAffected ());
-            notifyAudioSourceDependentObjectsContentChanged (audioSource, ARA::ContentUpdateScopes::notesAreAffected ());
+            if (analysisTask->isPartialAnalysis ())
+            {
+                // only notify the range that actually has been re-analyzed, merging with any pending update
+                const auto& analyzedSampleRange { analysisTask->getAnalyzedSampleRange () };
+                auto rangeStart { ARA::timeAtSamplePosition (analyzedSampleRange.first, audioSource->getSampleRate ()) };
+                auto rangeEnd { ARA::timeAtSamplePosition (analyzedSampleRange.second, audioSource->getSampleRate ()) };
+                const auto pendingUpdate { _pendingNoteContentUpdateRanges.find (audioSource) };
+                if (pendingUpdate != _pendingNoteContentUpdateRanges.end ())
+                {
+                    rangeStart = std::min (rangeStart, pendingUpdate->second.start);
+                    rangeEnd = std::max (rangeEnd, pendingUpdate->second.start + pendingUpdate->second.duration);
+                }
+                _pendingNoteContentUpdateRanges[audioSource] = ARA::ARAContentTimeRange { rangeStart, rangeEnd - rangeStart };
+            }
+            else
+            {
+                notifyAudioSourceContentChanged (audioSource, ARA::ContentUpdateScopes::notesAreAffected ());
+                notifyAudioSourceDependentObjectsContentChanged (audioSource, ARA::ContentUpdateScopes::notesAreAffected ());
+            }
         }
 
-        analysisTaskIt = _activeAnalysisTasks.erase (analysisTaskIt);
+        ARA::find_erase (_activeAnalysisTasks, analysisTask);
     }
 }
 
@@ -388,6 +615,39 @@ void ARATestDocumentController::notifyAudioSourceDependentObjectsContentChanged
     }
 }
 
+void ARATestDocumentController::notifyPendingNoteContentUpdateRanges ()
+{
+    if (auto hostModelUpdateController { getHostModelUpdateController () })
+    {
+        for (const auto& pendingUpdate : _pendingNoteContentUpdateRanges)
+        {
+            const auto audioSource { pendingUpdate.first };
+            const auto& range { pendingUpdate.second };
+            hostModelUpdateController->notifyAudioSourceContentChanged (audioSource->getHostRef (), &range, ARA::ContentUpdateScopes::notesAreAffected ());
+
+            for (auto& audioModification : audioSource->getAudioModifications ())
+            {
+                hostModelUpdateController->notifyAudioModificationContentChanged (audioModification->getHostRef (), &range, ARA::ContentUpdateScopes::notesAreAffected ());
+
+                // convert the range to playback time for each region that intersects it
+                for (auto& playbackRegion : audioModification->getPlaybackRegions ())
+                {
+                    const auto regionStart { std::max (range.start, playbackRegion->getStartInAudioModificationTime ()) };
+                    const auto regionEnd { std::min (range.start + range.duration, playbackRegion->getStartInAudioModificationTime () + playbackRegion->getDurationInAudioModificationTime ()) };
+                    if (regionEnd <= regionStart)
+                        continue;
+
+                    const auto timeOffset { playbackRegion->getStartInPlaybackTime () - playbackRegion->getStartInAudioModificationTime () };
+                    const ARA::ARAContentTimeRange playbackRange { regionStart + timeOffset, regionEnd - regionStart };
+                    hostModelUpdateController->notifyPlaybackRegionContentChanged (playbackRegion->getHostRef (), &playbackRange, ARA::ContentUpdateScopes::notesAreAffected ());
+                }
+            }
+        }
+    }
+
+    _pendingNoteContentUpdateRanges.clear ();
+}
+
 bool ARATestDocumentController::tryCopyHostNoteContent (ARATestAudioSource* audioSource)
 {
     auto hostNoteReader { ARA::PlugIn::HostContentReader<ARA::kARAContentTypeNotes> (audioSource) };
@@ -441,12 +701,66 @@ void ARATestDocumentController::updateAudioSourceAfterContentOrAlgorithmChanged
     }
 }
 
+void ARATestDocumentController::updateAudioSourceAfterSamplesChanged (ARATestAudioSource* audioSource, const ARA::ARAContentTimeRange* range)
+{
+    // notes provided by the host do not depend on the samples
+    if (audioSource->getNoteContentWasReadFromHost ())
+        return;
+
+    // if there is no previous analysis result to update, or no range was specified,
+    // or a full analysis is pending anyways, we need to (re-)start the full analysis if needed
+    const auto activeAnalysisTask { getActiveAnalysisTaskForAudioSource (audioSource) };
+    const bool isScheduledForAnalysis { _audioSourcesScheduledForAnalysis.count (audioSource) != 0 };
+    if (!range || (audioSource->getNoteContent () == nullptr) || isScheduledForAnalysis ||
+        (activeAnalysisTask && !activeAnalysisTask->isPartialAnalysis ()))
+    {
+        if ((audioSource->getNoteContent () != nullptr) || activeAnalysisTask || isScheduledForAnalysis)
+            updateAudioSourceAfterContentOrAlgorithmChanged (audioSource, false);
+        return;
+    }
+
+    // otherwise schedule re-analysis of the changed samples, merged with any ongoing or pending re-analysis
+    const auto sampleCount { audioSource->getSampleCount () };
+    std::pair<int64_t, int64_t> changedSampleRange { std::max<int64_t> (0, ARA::samplePositionAtTime (range->start, audioSource->getSampleRate ())),
+                                                     std::min<int64_t> (sampleCount, ARA::samplePositionAtTime (range->start + range->duration, audioSource->getSampleRate ()) + 1) };
+    if (activeAnalysisTask)
+    {
+        changedSampleRange.first = std::min (changedSampleRange.first, activeAnalysisTask->getChangedSampleRange ().first);
+        changedSampleRange.second = std::max (changedSampleRange.second, activeAnalysisTask->getChangedSampleRange ().second);
+        cancelAnalysisTaskForAudioSource (audioSource);
+    }
+    const auto scheduledReanalysis { _audioSourcesScheduledForReanalysis.find (audioSource) };
+    if (scheduledReanalysis != _audioSourcesScheduledForReanalysis.end ())
+    {
+        changedSampleRange.first = std::min (changedSampleRange.first, scheduledReanalysis->second.first);
+        changedSampleRange.second = std::max (changedSampleRange.second, scheduledReanalysis->second.second);
+    }
+
+    // postpone if host is currently editing or access is not enabled, otherwise start immediately
+    if (isHostEditingDocument () || !audioSource->isSampleAccessEnabled ())
+    {
+        _audioSourcesScheduledForReanalysis[audioSource] = changedSampleRange;
+    }
+    else
+    {
+        _audioSourcesScheduledForReanalysis.erase (audioSource);
+        startAnalysisTaskForAudioSource (audioSource, &changedSampleRange);
+    }
+}
+
 /*******************************************************************************/
 
 void ARATestDocumentController::willNotifyModelUpdates () noexcept
 {
+    // the host's update cycle drives the virtual analysis clock, if enabled
+    if (TestAnalysisPacing::getMode () == TestAnalysisPacing::Mode::virtualClock)
+        TestAnalysisPacing::advanceVirtualClock ();
+
     if (!isHostEditingDocument ())
+    {
         processCompletedAnalysisTasks ();
+        notifyPendingNoteContentUpdateRanges ();
+    }
 }
 
 /*******************************************************************************/
@@ -472,6 +786,21 @@ void ARATestDocumentController::didEndEditing () noexcept
         startAnalysisTaskForAudioSource (*audioSourceIt);
         audioSourceIt = _audioSourcesScheduledForAnalysis.erase (audioSourceIt);
     }
+
+    auto reanalysisIt { _audioSourcesScheduledForReanalysis.begin () };
+    while (reanalysisIt != _audioSourcesScheduledForReanalysis.end ())
+    {
+        if (!reanalysisIt->first->isSampleAccessEnabled ())
+        {
+            ++reanalysisIt;
+            continue;
+        }
+
+        const auto audioSource { reanalysisIt->first };
+        const auto changedSampleRange { reanalysisIt->second };
+        reanalysisIt = _audioSourcesScheduledForReanalysis.erase (reanalysisIt);
+        startAnalysisTaskForAudioSource (audioSource, &changedSampleRange);
+    }
 }
 
 /*******************************************************************************/
@@ -638,6 +967,7 @@ void ARATestDocumentController::willUpdateAudioSourceProperties (ARA::PlugIn::Au
         // if we have a self-analyzed content, clear it and schedule reanalysis
         // (actual plug-ins may instead be able to create a new result based on the old one)
         auto testAudioSource { static_cast<ARATestAudioSource*> (audioSource) };
+        testAudioSource->clearAnalysisCacheKey ();
         if (!testAudioSource->getNoteContentWasReadFromHost ())
             updateAudioSourceAfterContentOrAlgorithmChanged (testAudioSource, false);
     }
@@ -651,11 +981,17 @@ void ARATestDocumentController::doUpdateAudioSourceContent (ARA::PlugIn::AudioSo
 
     auto testAudioSource { static_cast<ARATestAudioSource*> (audioSource) };
 
-    if (scopeFlags.affectSamples () && testAudioSource->isSampleAccessEnabled ())
-        testAudioSource->updateRenderSampleCache ();
+    if (scopeFlags.affectSamples ())
+    {
+        testAudioSource->clearAnalysisCacheKey ();
+        if (testAudioSource->isSampleAccessEnabled ())
+            testAudioSource->updateRenderSampleCache ();
+    }
 
     if (scopeFlags.affectNotes ())
         updateAudioSourceAfterContentOrAlgorithmChanged (testAudioSource, true);
+    else if (scopeFlags.affectSamples ())
+        updateAudioSourceAfterSamplesChanged (testAudioSource, range);
 }
 
 void ARATestDocumentController::willEnableAudioSourceSamplesAccess (ARA::PlugIn::AudioSource* audioSource, bool enable) noexcept
@@ -694,6 +1030,14 @@ void ARATestDocumentController::didEnableAudioSourceSamplesAccess (ARA::PlugIn::
             startAnalysisTaskForAudioSource (testAudioSource);
             _audioSourcesScheduledForAnalysis.erase (testAudioSource);
         }
+
+        const auto scheduledReanalysis { _audioSourcesScheduledForReanalysis.find (testAudioSource) };
+        if (scheduledReanalysis != _audioSourcesScheduledForReanalysis.end ())
+        {
+            const auto changedSampleRange { scheduledReanalysis->second };
+            _audioSourcesScheduledForReanalysis.erase (scheduledReanalysis);
+            startAnalysisTaskForAudioSource (testAudioSource, &changedSampleRange);
+        }
     }
 }
 
@@ -717,6 +1061,7 @@ void ARATestDocumentController::willDestroyAudioSource (ARA::PlugIn::AudioSource
     auto testAudioSource { static_cast<ARATestAudioSource*> (audioSource) };
 
     cancelAnalysisOfAudioSource (testAudioSource);
+    _pendingNoteContentUpdateRanges.erase (testAudioSource);
 }
 
 /*******************************************************************************/
@@ -767,15 +1112,15 @@ ARA::PlugIn::ContentReader* ARATestDocumentController::doCreateAudioModification
 
 bool ARATestDocumentController::doIsPlaybackRegionContentAvailable (const ARA::PlugIn::PlaybackRegion* playbackRegion, ARA::ARAContentType type) noexcept
 {
-    // since this demo plug-in plays back all modification data as is (no time stretching etc.),
-    // we can directly forward the audio modification data
+    // since the region content is mapped from the audio modification content (see ARATestNoteContentReader),
+    // it is available whenever the modification content is
     return doIsAudioModificationContentAvailable (playbackRegion->getAudioModification (), type);
 }
 
 ARA::ARAContentGrade ARATestDocumentController::doGetPlaybackRegionContentGrade (const ARA::PlugIn::PlaybackRegion* playbackRegion, ARA::ARAContentType type) noexcept
 {
-    // since this demo plug-in plays back all modification data as is (no time stretching etc.),
-    // we can directly forward the audio modification data
+    // since this demo plug-in plays back the modification data either as is or linearly time stretched,
+    // mapping it to playback time loses no information, so the modification content grade applies
     return doGetAudioModificationContentGrade (playbackRegion->getAudioModification (), type);
 }
 
@@ -901,6 +1246,11 @@ void ARATestDocumentController::disableRendererModelGraphAccess () noexcept
 void ARATestDocumentController::enableRendererModelGraphAccess () noexcept
 {
     ARA_INTERNAL_ASSERT (!_renderersCanAccessModelGraph);
+
+    // audio sources and playback regions may have changed while renderers could not access the model graph
+    for (auto playbackRenderer : getPlaybackRenderers<ARATestPlaybackRenderer> ())
+        playbackRenderer->updateRenderResources ();
+
     _renderersCanAccessModelGraph = true;
 }
 
@@ -926,6 +1276,8 @@ public:
     const ARA::ARAPersistentID* getCompatibleDocumentArchiveIDs () const noexcept override { static const auto id { TEST_FILECHUNK_ARCHIVE_ID }; return &id; }
 
     bool supportsStoringAudioFileChunks () const noexcept override { return true; }
+
+    ARA::ARAPlaybackTransformationFlags getSupportedPlaybackTransformationFlags () const noexcept override { return ARA::kARAPlaybackTransformationTimestretch; }
 };
 
 const ARA::ARAFactory* ARATestDocumentController::getARAFactory () noexcept
@@ -23,7 +23,10 @@
 
 #include "TestAnalysis.h"
 
+#include <map>
+#include <mutex>
 #include <unordered_set>
+#include <utility>
 
 
 // By default, the test plug-in only analyzes audio sources when explicitly requested by the host,
@@ -43,6 +46,28 @@
     #define ARA_SIMULATE_USER_INTERACTION 0
 #endif
 
+// If the sample rate of an audio source differs from the sample rate of the playback renderer,
+// the samples are converted using a windowed-sinc resampler (see TestResampler). This define
+// sets the kernel half width in source samples: lower values reduce the CPU load of resampling,
+// at the price of a narrower pass band. The ARATestHost "ResamplingBenchmark" test measures
+// both CPU load and signal-to-noise ratio of the conversion.
+#if !defined (ARA_RESAMPLER_KERNEL_HALF_WIDTH)
+    #define ARA_RESAMPLER_KERNEL_HALF_WIDTH 32
+#endif
+
+// Playback regions that overlap a render block can be rendered concurrently on a pool of worker
+// threads (see TestRenderWorkerPool), which pays off for costly per-region processing such as
+// resampling or time stretching. This define sets the number of worker threads in addition to the
+// render thread, the pool is shared by all playback renderers. Setting it to 0 renders all regions
+// serially on the render thread. Blocks with less than ARA_PARALLEL_RENDERING_MIN_BLOCK_SIZE samples
+// are always rendered serially, since distributing them costs more than it gains.
+#if !defined (ARA_PARALLEL_RENDERING_WORKER_THREAD_COUNT)
+    #define ARA_PARALLEL_RENDERING_WORKER_THREAD_COUNT 3
+#endif
+#if !defined (ARA_PARALLEL_RENDERING_MIN_BLOCK_SIZE)
+    #define ARA_PARALLEL_RENDERING_MIN_BLOCK_SIZE 64
+#endif
+
 
 class ARATestAudioSource;
 class ARATestPlaybackRenderer;
@@ -141,11 +166,16 @@ public:
     void startOrScheduleAnalysisOfAudioSource (ARATestAudioSource* audioSource);    // does nothing if already analyzing
     bool cancelAnalysisOfAudioSource (ARATestAudioSource* audioSource);
 
+    // called by analysis tasks from their worker thread when done, so that the main thread
+    // only needs to process the tasks in this queue instead of polling all active tasks
+    void enqueueCompletedAnalysisTask (ARATestAnalysisTask* analysisTask);
+
 private:
     void disableRendererModelGraphAccess () noexcept;
     void enableRendererModelGraphAccess () noexcept;
 
-    void startAnalysisTaskForAudioSource (ARATestAudioSource* audioSource);
+    // if changedSampleRange is provided, only the changed samples are re-analyzed and merged with the current note content
+    void startAnalysisTaskForAudioSource (ARATestAudioSource* audioSource, const std::pair<int64_t, int64_t>* changedSampleRange = nullptr);
     bool cancelAnalysisTaskForAudioSource (ARATestAudioSource* audioSource);
     ARATestAnalysisTask* getActiveAnalysisTaskForAudioSource (const ARATestAudioSource* audioSource) noexcept; // returns nullptr if no active analysis for given audio source
     void processCompletedAnalysisTasks ();
@@ -154,6 +184,10 @@ private:
     // we always must notify their changes when changing the audio source content.
     void notifyAudioSourceDependentObjectsContentChanged (ARATestAudioSource* audioSource, ARA::ContentUpdateScopes scopeFlags);
 
+    // the ARA library does not provide a way to specify the time range of content updates,
+    // so after partial re-analysis, we directly send the notifications to the host
+    void notifyPendingNoteContentUpdateRanges ();
+
     bool tryCopyHostNoteContent (ARATestAudioSource* audioSource);
 
     // if audio samples or note content or processing algorithm changes, we need to:
@@ -164,9 +198,16 @@ private:
     //   dependent audio modifications and playback regions
     void updateAudioSourceAfterContentOrAlgorithmChanged (ARATestAudioSource* audioSource, bool hostChangedContent);
 
+    // if samples change, we only need to re-analyze the affected range (unless the host provided the notes)
+    void updateAudioSourceAfterSamplesChanged (ARATestAudioSource* audioSource, const ARA::ARAContentTimeRange* range);
+
 private:
     std::unordered_set<ARATestAudioSource*> _audioSourcesScheduledForAnalysis;
+    std::map<ARATestAudioSource*, std::pair<int64_t, int64_t>> _audioSourcesScheduledForReanalysis;  // maps to changed sample range
+    std::map<ARATestAudioSource*, ARA::ARAContentTimeRange> _pendingNoteContentUpdateRanges;
     std::vector<std::unique_ptr<ARATestAnalysisTask>> _activeAnalysisTasks;
+    std::mutex _completedAnalysisTasksMutex;
+    std::vector<ARATestAnalysisTask*> _completedAnalysisTasks;
 
     std::atomic<bool> _renderersCanAccessModelGraph { true };
     std::atomic<int> _countOfRenderersCurrentlyAccessingModelGraph { 0 };
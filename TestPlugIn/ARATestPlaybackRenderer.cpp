@@ -20,14 +20,388 @@
 #include "ARATestPlaybackRenderer.h"
 #include "ARATestDocumentController.h"
 #include "ARATestAudioSource.h"
+#include "TestResampler.h"
+#include "TestTimeStretcher.h"
 
-void ARATestPlaybackRenderer::renderPlaybackRegions (float* const* ppOutput, ARA::ARASamplePosition samplePosition,
+#include "ExamplesCommon/Utilities/StdUniquePtrUtilities.h"
+
+#include <cmath>
+#include <thread>
+
+// SIMD instruction sets used to optimize summing up the output of parallel rendering
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define ARA_TEST_RENDERER_USE_SSE2 1
+    #include <emmintrin.h>
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__) || defined (_M_ARM64)
+    #define ARA_TEST_RENDERER_USE_NEON 1
+    #include <arm_neon.h>
+#endif
+
+// output[i] += input[i]
+static void addToBuffer (float* output, const float* input, const size_t count) noexcept
+{
+    size_t i { 0 };
+#if ARA_TEST_RENDERER_USE_SSE2 || ARA_TEST_RENDERER_USE_NEON
+    const auto vectorizedCount { count - count % 4 };
+#endif
+#if ARA_TEST_RENDERER_USE_SSE2
+    for (; i < vectorizedCount; i += 4)
+        _mm_storeu_ps (output + i, _mm_add_ps (_mm_loadu_ps (output + i), _mm_loadu_ps (input + i)));
+#elif ARA_TEST_RENDERER_USE_NEON
+    for (; i < vectorizedCount; i += 4)
+        vst1q_f32 (output + i, vaddq_f32 (vld1q_f32 (output + i), vld1q_f32 (input + i)));
+#endif
+    for (; i < count; ++i)
+        output[i] += input[i];
+}
+
+static void addToBuffer (double* output, const double* input, const size_t count) noexcept
+{
+    size_t i { 0 };
+#if ARA_TEST_RENDERER_USE_SSE2
+    const auto vectorizedCount { count - count % 2 };
+    for (; i < vectorizedCount; i += 2)
+        _mm_storeu_pd (output + i, _mm_add_pd (_mm_loadu_pd (output + i), _mm_loadu_pd (input + i)));
+#endif
+    for (; i < count; ++i)
+        output[i] += input[i];
+}
+
+// add samples provided by readSample (channel, index) to the output, converting between float
+// and double as needed if the precision of the samples does not match the precision of the output
+template <typename OutputSampleType, typename SampleReader>
+static void addSamples (ARA::ARAChannelCount sourceChannelCount, const SampleReader& readSample,
+                        OutputSampleType* const* ppOutput, ARA::ARAChannelCount outputChannelCount,
+                        ARA::ARASamplePosition startInBuffer, ARA::ARASampleCount sampleCount)
+{
+    if (sourceChannelCount == outputChannelCount)
+    {
+        for (auto c { 0 }; c < sourceChannelCount; ++c)
+        {
+            const auto output { ppOutput[c] + startInBuffer };
+            for (auto i { 0 }; i < sampleCount; ++i)
+                output[i] += static_cast<OutputSampleType> (readSample (c, i));
+        }
+    }
+    else
+    {
+        // crude channel format conversion:
+        // mix down to mono, then distribute the mono signal evenly to all channels.
+        // note that when down-mixing to mono, the result is scaled by channel count,
+        // whereas upon up-mixing it is just copied to all channels.
+        // \todo ambisonic formats should just stick with the mono sum on channel 0,
+        //       but in this simple test code we currently do not distinguish ambisonics
+        using SourceSampleType = decltype (readSample (0, 0));
+        for (auto i { 0 }; i < sampleCount; ++i)
+        {
+            SourceSampleType monoSum { 0 };
+            for (auto c { 0 }; c < sourceChannelCount; ++c)
+                monoSum += readSample (c, i);
+            if (sourceChannelCount > 1)
+                monoSum /= static_cast<SourceSampleType> (sourceChannelCount);
+            for (auto c { 0 }; c < outputChannelCount; ++c)
+                ppOutput[c][startInBuffer + i] += static_cast<OutputSampleType> (monoSum);
+        }
+    }
+}
+
+// add samples from the audio source render cache, starting at the given source sample
+template <typename CacheSampleType, typename OutputSampleType>
+static void addAudioSourceSamples (const ARATestAudioSource* audioSource, ARA::ARASamplePosition startInSource,
+                                   OutputSampleType* const* ppOutput, ARA::ARAChannelCount outputChannelCount,
+                                   ARA::ARASamplePosition startInBuffer, ARA::ARASampleCount sampleCount)
+{
+    const auto readSample { [audioSource, startInSource] (ARA::ARAChannelCount c, ARA::ARASampleCount i) -> CacheSampleType
+                            {
+                                return audioSource->getRenderSampleCacheForChannel<CacheSampleType> (c)[startInSource + i];
+                            } };
+    addSamples (audioSource->getChannelCount (), readSample, ppOutput, outputChannelCount, startInBuffer, sampleCount);
+}
+
+// add samples from the audio source render cache, resampled to the output sample rate -
+// only the source samples in the given available range are used, everything outside is treated as silence
+template <typename CacheSampleType, typename OutputSampleType>
+static void addResampledAudioSourceSamples (const ARATestAudioSource* audioSource, const TestResampler* resampler,
+                                            ARA::ARASamplePosition startAvailableSourceSamples, ARA::ARASamplePosition endAvailableSourceSamples,
+                                            double startPositionInSource, double sourceSamplesPerOutputSample,
+                                            OutputSampleType* const* ppOutput, ARA::ARAChannelCount outputChannelCount,
+                                            ARA::ARASamplePosition startInBuffer, ARA::ARASampleCount sampleCount)
+{
+    const auto availableSourceSampleCount { endAvailableSourceSamples - startAvailableSourceSamples };
+    const auto startPositionInAvailableSamples { startPositionInSource - static_cast<double> (startAvailableSourceSamples) };
+    const auto readSample { [=] (ARA::ARAChannelCount c, ARA::ARASampleCount i) -> CacheSampleType
+                            {
+                                const auto availableSamples { audioSource->getRenderSampleCacheForChannel<CacheSampleType> (c) + startAvailableSourceSamples };
+                                const auto position { startPositionInAvailableSamples + static_cast<double> (i) * sourceSamplesPerOutputSample };
+                                return resampler->interpolate (availableSamples, availableSourceSampleCount, position);
+                            } };
+    addSamples (audioSource->getChannelCount (), readSample, ppOutput, outputChannelCount, startInBuffer, sampleCount);
+}
+
+// provides the samples of an audio source to the time stretcher at the render sample rate,
+// treating samples outside of the given available range as silence
+template <typename CacheSampleType>
+class TimeStretcherSourceReader : public TestTimeStretcher::SourceReader
+{
+public:
+    TimeStretcherSourceReader (const ARATestAudioSource* audioSource, const TestResampler* resampler, double sourceSamplesPerRenderSample,
+                               ARA::ARASamplePosition startAvailableSourceSamples, ARA::ARASamplePosition endAvailableSourceSamples) noexcept
+    : _audioSource { audioSource },
+      _resampler { resampler },
+      _sourceSamplesPerRenderSample { sourceSamplesPerRenderSample },
+      _startAvailableSourceSamples { startAvailableSourceSamples },
+      _endAvailableSourceSamples { endAvailableSourceSamples }
+    {}
+
+    void readSamples (int channel, int64_t position, int64_t count, float samples[]) const noexcept override
+    {
+        const auto source { _audioSource->getRenderSampleCacheForChannel<CacheSampleType> (channel) };
+        if (_resampler)
+        {
+            const auto availableSamples { source + _startAvailableSourceSamples };
+            const auto availableSampleCount { _endAvailableSourceSamples - _startAvailableSourceSamples };
+            for (int64_t i { 0 }; i < count; ++i)
+            {
+                const auto positionInAvailableSamples { static_cast<double> (position + i) * _sourceSamplesPerRenderSample - static_cast<double> (_startAvailableSourceSamples) };
+                samples[i] = static_cast<float> (_resampler->interpolate (availableSamples, availableSampleCount, positionInAvailableSamples));
+            }
+        }
+        else
+        {
+            for (int64_t i { 0 }; i < count; ++i)
+            {
+                const auto sourcePosition { position + i };
+                const auto isAvailable { (_startAvailableSourceSamples <= sourcePosition) && (sourcePosition < _endAvailableSourceSamples) };
+                samples[i] = (isAvailable) ? static_cast<float> (source[sourcePosition]) : 0.0f;
+            }
+        }
+    }
+
+private:
+    const ARATestAudioSource* const _audioSource;
+    const TestResampler* const _resampler;
+    const double _sourceSamplesPerRenderSample;
+    const ARA::ARASamplePosition _startAvailableSourceSamples;
+    const ARA::ARASamplePosition _endAvailableSourceSamples;
+};
+
+// add time stretched samples from the audio source render cache, starting at the given sample relative to the region start
+template <typename CacheSampleType, typename OutputSampleType>
+static void addTimeStretchedAudioSourceSamples (const ARATestAudioSource* audioSource, TestTimeStretcher* timeStretcher,
+                                                const TimeStretcherSourceReader<CacheSampleType>& reader, double sourceStart, double stretchFactor,
+                                                ARA::ARASamplePosition startInRegion, OutputSampleType* const* ppOutput, ARA::ARAChannelCount outputChannelCount,
+                                                ARA::ARASamplePosition startInBuffer, ARA::ARASampleCount sampleCount)
+{
+    for (ARA::ARASampleCount offset { 0 }; offset < sampleCount; offset += timeStretcher->getMaxSampleCount ())
+    {
+        const auto count { std::min (sampleCount - offset, timeStretcher->getMaxSampleCount ()) };
+        timeStretcher->render (reader, sourceStart, stretchFactor, startInRegion + offset, count);
+        const auto readSample { [timeStretcher] (ARA::ARAChannelCount c, ARA::ARASampleCount i) -> float
+                                {
+                                    return timeStretcher->getOutputChannel (c)[i];
+                                } };
+        addSamples (audioSource->getChannelCount (), readSample, ppOutput, outputChannelCount, startInBuffer + offset, count);
+    }
+}
+
+static bool isTimeStretched (const ARA::PlugIn::PlaybackRegion* playbackRegion) noexcept
+{
+    return playbackRegion->isTimestretchEnabled () &&
+           (playbackRegion->getDurationInAudioModificationTime () != playbackRegion->getDurationInPlaybackTime ());
+}
+
+ARATestPlaybackRenderer::ARATestPlaybackRenderer (ARA::PlugIn::DocumentController* documentController) noexcept
+: PlaybackRenderer { documentController }
+{}
+
+ARATestPlaybackRenderer::~ARATestPlaybackRenderer () = default;
+
+template <typename SampleType>
+void ARATestPlaybackRenderer::renderPlaybackRegion (const ARA::PlugIn::PlaybackRegion* playbackRegion, SampleType* const* ppOutput,
+                                                    ARA::ARASamplePosition samplePosition, ARA::ARASampleCount samplesToRender) noexcept
+{
+    const auto audioSource { playbackRegion->getAudioModification ()->getAudioSource<const ARATestAudioSource> () };
+
+    // if the sample rates differ, the samples are resampled - the resampler has been
+    // prepared in updateRenderResources () since it cannot be created on the render thread
+    const auto sourceSampleRate { audioSource->getSampleRate () };
+    const TestResampler* resampler { nullptr };
+    if (sourceSampleRate != _sampleRate)
+    {
+        resampler = getResampler (sourceSampleRate);
+        ARA_INTERNAL_ASSERT (resampler != nullptr);
+        if (!resampler)
+            return;
+    }
+
+    // calculate sample range to copy in song time
+    const auto sampleEnd { samplePosition + samplesToRender };
+    const auto regionStartSample { playbackRegion->getStartInPlaybackSamples (_sampleRate) };
+    const auto regionEndSample { playbackRegion->getEndInPlaybackSamples (_sampleRate) };
+    auto startSongSample { std::max (regionStartSample, samplePosition) };
+    auto endSongSample { std::min (regionEndSample, sampleEnd) };
+
+    // clip at region borders in audio source samples
+    const auto startAvailableSourceSamples { std::max (ARA::ARASamplePosition { 0 }, playbackRegion->getStartInAudioModificationSamples ()) };
+    const auto endAvailableSourceSamples { std::min (audioSource->getSampleCount (), playbackRegion->getEndInAudioModificationSamples ()) };
+
+    // if time stretching, song sample s is located at (sourceStart + (s - regionStartSample) * stretchFactor)
+    // in the audio source, measured in samples at the render sample rate
+    if (const auto timeStretcher { getTimeStretcher (playbackRegion) })
+    {
+        const auto sourceStart { playbackRegion->getStartInAudioModificationTime () * _sampleRate };
+        const auto stretchFactor { playbackRegion->getDurationInAudioModificationTime () / playbackRegion->getDurationInPlaybackTime () };
+        const auto sourceSamplesPerRenderSample { sourceSampleRate / _sampleRate };
+        const auto startInRegion { startSongSample - regionStartSample };
+        const auto startInBuffer { startSongSample - samplePosition };
+        const auto sampleCount { endSongSample - startSongSample };
+        if (audioSource->isRenderSampleCacheDoublePrecision ())
+        {
+            const TimeStretcherSourceReader<double> reader { audioSource, resampler, sourceSamplesPerRenderSample, startAvailableSourceSamples, endAvailableSourceSamples };
+            addTimeStretchedAudioSourceSamples (audioSource, timeStretcher, reader, sourceStart, stretchFactor, startInRegion, ppOutput, _channelCount, startInBuffer, sampleCount);
+        }
+        else
+        {
+            const TimeStretcherSourceReader<float> reader { audioSource, resampler, sourceSamplesPerRenderSample, startAvailableSourceSamples, endAvailableSourceSamples };
+            addTimeStretchedAudioSourceSamples (audioSource, timeStretcher, reader, sourceStart, stretchFactor, startInRegion, ppOutput, _channelCount, startInBuffer, sampleCount);
+        }
+    }
+    else if (!resampler)
+    {
+        // calculate offset between song and audio source samples
+        const auto offsetToPlaybackRegion { playbackRegion->getStartInAudioModificationSamples () - regionStartSample };
+
+        startSongSample = std::max (startSongSample, startAvailableSourceSamples - offsetToPlaybackRegion);
+        endSongSample = std::min (endSongSample, endAvailableSourceSamples - offsetToPlaybackRegion);
+        if (endSongSample <= startSongSample)
+            return;
+
+        // add samples from audio source
+        const auto startInSource { startSongSample + offsetToPlaybackRegion };
+        const auto startInBuffer { startSongSample - samplePosition };
+        const auto sampleCount { endSongSample - startSongSample };
+        if (audioSource->isRenderSampleCacheDoublePrecision ())
+            addAudioSourceSamples<double> (audioSource, startInSource, ppOutput, _channelCount, startInBuffer, sampleCount);
+        else
+            addAudioSourceSamples<float> (audioSource, startInSource, ppOutput, _channelCount, startInBuffer, sampleCount);
+    }
+    else
+    {
+        // song sample s is located at (sourceOffset + s * sourceSamplesPerSongSample) in the audio source
+        const auto sourceSamplesPerSongSample { sourceSampleRate / _sampleRate };
+        const auto sourceOffset { (playbackRegion->getStartInAudioModificationTime () - playbackRegion->getStartInPlaybackTime ()) * sourceSampleRate };
+
+        const auto toSongSample { [&] (ARA::ARASamplePosition sourceSample)
+                                  {
+                                      return static_cast<ARA::ARASamplePosition> (std::ceil ((static_cast<double> (sourceSample) - sourceOffset) / sourceSamplesPerSongSample));
+                                  } };
+        startSongSample = std::max (startSongSample, toSongSample (startAvailableSourceSamples));
+        endSongSample = std::min (endSongSample, toSongSample (endAvailableSourceSamples));
+        if (endSongSample <= startSongSample)
+            return;
+
+        // add resampled samples from audio source
+        const auto startPositionInSource { sourceOffset + static_cast<double> (startSongSample) * sourceSamplesPerSongSample };
+        const auto startInBuffer { startSongSample - samplePosition };
+        const auto sampleCount { endSongSample - startSongSample };
+        if (audioSource->isRenderSampleCacheDoublePrecision ())
+            addResampledAudioSourceSamples<double> (audioSource, resampler, startAvailableSourceSamples, endAvailableSourceSamples,
+                                                    startPositionInSource, sourceSamplesPerSongSample, ppOutput, _channelCount, startInBuffer, sampleCount);
+        else
+            addResampledAudioSourceSamples<float> (audioSource, resampler, startAvailableSourceSamples, endAvailableSourceSamples,
+                                                   startPositionInSource, sourceSamplesPerSongSample, ppOutput, _channelCount, startInBuffer, sampleCount);
+    }
+}
+
+template <typename SampleType>
+class ARATestPlaybackRenderer::ParallelRenderJob : public TestRenderWorkerPool::Job
+{
+public:
+    ParallelRenderJob (ARATestPlaybackRenderer* renderer, ARA::ARASamplePosition samplePosition, ARA::ARASampleCount samplesToRender) noexcept
+    : _renderer { renderer },
+      _samplePosition { samplePosition },
+      _samplesToRender { samplesToRender }
+    {}
+
+    void processItem (size_t itemIndex, int workerIndex) noexcept override
+    {
+        auto& scratch { _renderer->_renderScratch[static_cast<size_t> (workerIndex)] };
+        const auto channels { scratch.getChannels<SampleType> () };
+        if (!scratch._hasSamples)
+        {
+            for (auto c { 0 }; c < _renderer->_channelCount; ++c)
+                std::memset (channels[c], 0, sizeof (SampleType) * static_cast<size_t> (_samplesToRender));
+            scratch._hasSamples = true;
+        }
+        _renderer->renderPlaybackRegion (_renderer->_regionsToRender[itemIndex], channels, _samplePosition, _samplesToRender);
+    }
+
+private:
+    ARATestPlaybackRenderer* const _renderer;
+    const ARA::ARASamplePosition _samplePosition;
+    const ARA::ARASampleCount _samplesToRender;
+};
+
+template <>
+float* const* ARATestPlaybackRenderer::RenderScratch::getChannels<float> () noexcept
+{
+    return _channels32.data ();
+}
+
+template <>
+double* const* ARATestPlaybackRenderer::RenderScratch::getChannels<double> () noexcept
+{
+    return _channels64.data ();
+}
+
+template <typename SampleType>
+bool ARATestPlaybackRenderer::renderPlaybackRegionsInParallel (SampleType* const* ppOutput, ARA::ARASamplePosition samplePosition, ARA::ARASampleCount samplesToRender) noexcept
+{
+    if (_renderScratch.empty () || (_regionsToRender.size () < 2) || (samplesToRender < ARA_PARALLEL_RENDERING_MIN_BLOCK_SIZE))
+        return false;
+
+    for (auto& scratch : _renderScratch)
+        scratch._hasSamples = false;
+
+    ParallelRenderJob<SampleType> job { this, samplePosition, samplesToRender };
+    if (_hostThreadPool)
+    {
+        // each host task acts as one worker, rendering regions until none are left
+        _hostThreadPoolJob = &job;
+        _nextHostThreadPoolItemIndex.store (0, std::memory_order_relaxed);
+        const auto taskCount { std::min (_regionsToRender.size (), _renderScratch.size ()) };
+        const auto didExecute { _hostThreadPool->requestExecution (static_cast<uint32_t> (taskCount)) };
+        _hostThreadPoolJob = nullptr;
+        if (!didExecute)
+            return false;
+    }
+    else
+    {
+        // if the pool is busy with another render thread, render serially instead of waiting
+        if (!_workerPool->perform (job, _regionsToRender.size ()))
+            return false;
+    }
+
+    // sum up the output of all workers that rendered any region
+    for (auto& scratch : _renderScratch)
+    {
+        if (!scratch._hasSamples)
+            continue;
+        const auto channels { scratch.getChannels<SampleType> () };
+        for (auto c { 0 }; c < _channelCount; ++c)
+            addToBuffer (ppOutput[c], channels[c], static_cast<size_t> (samplesToRender));
+    }
+    return true;
+}
+
+template <typename SampleType>
+void ARATestPlaybackRenderer::renderPlaybackRegions (SampleType* const* ppOutput, ARA::ARASamplePosition samplePosition,
                                                      ARA::ARASampleCount samplesToRender, bool isPlayingBack)
 {
     // initialize output buffers with silence, in case no viable playback region intersects with the
     // current buffer, or if the model is currently not accessible due to being edited.
     for (auto c { 0 }; c < _channelCount; ++c)
-        std::memset (ppOutput[c], 0, sizeof (float) * static_cast<size_t> (samplesToRender));
+        std::memset (ppOutput[c], 0, sizeof (SampleType) * static_cast<size_t> (samplesToRender));
 
     // only output samples while host is playing back
     if (!isPlayingBack)
@@ -38,7 +412,9 @@ void ARATestPlaybackRenderer::renderPlaybackRegions (float* const* ppOutput, ARA
     auto docController { getDocumentController<ARATestDocumentController> () };
     if (docController->rendererWillAccessModelGraph (this))
     {
+        // collect the playback regions that intersect with the current buffer
         const auto sampleEnd { samplePosition + samplesToRender };
+        _regionsToRender.clear ();
         for (const auto& playbackRegion : getPlaybackRegions ())
         {
             const auto audioModification { playbackRegion->getAudioModification () };
@@ -52,63 +428,22 @@ void ARATestPlaybackRenderer::renderPlaybackRegions (float* const* ppOutput, ARA
             if (!audioSource->isSampleAccessEnabled ())
                 continue;
 
-            // this simplified test code "rendering" only produces audio if the sample rate matches
-            if (audioSource->getSampleRate () != _sampleRate)
-                continue;
-
-            // evaluate region borders in song time, calculate sample range to copy in song time
+            // evaluate region borders in song time
             // (if a plug-in uses playback region head/tail time, it will also need to reflect these values here)
-            const auto regionStartSample { playbackRegion->getStartInPlaybackSamples (_sampleRate) };
-            if (sampleEnd <= regionStartSample)
-                continue;
-
-            const auto regionEndSample { playbackRegion->getEndInPlaybackSamples (_sampleRate) };
-            if (regionEndSample <= samplePosition)
+            if ((sampleEnd <= playbackRegion->getStartInPlaybackSamples (_sampleRate)) ||
+                (playbackRegion->getEndInPlaybackSamples (_sampleRate) <= samplePosition))
                 continue;
 
-            auto startSongSample { std::max (regionStartSample, samplePosition) };
-            auto endSongSample { std::min (regionEndSample, sampleEnd) };
-
-            // calculate offset between song and audio source samples, clip at region borders in audio source samples
-            // (if a plug-in supports time stretching, it will also need to reflect the stretch factor here)
-            const auto offsetToPlaybackRegion { playbackRegion->getStartInAudioModificationSamples () - regionStartSample };
-
-            const auto startAvailableSourceSamples { std::max (ARA::ARASamplePosition { 0 }, playbackRegion->getStartInAudioModificationSamples ()) };
-            const auto endAvailableSourceSamples { std::min (audioSource->getSampleCount (), playbackRegion->getEndInAudioModificationSamples ()) };
-
-            startSongSample = std::max (startSongSample, startAvailableSourceSamples - offsetToPlaybackRegion);
-            endSongSample = std::min (endSongSample, endAvailableSourceSamples - offsetToPlaybackRegion);
-            if (endSongSample <= startSongSample)
-                continue;
+            // capacity has been reserved in updateRenderResources (), so this does not allocate
+            ARA_INTERNAL_ASSERT (_regionsToRender.size () < _regionsToRender.capacity ());
+            _regionsToRender.push_back (playbackRegion);
+        }
 
-            // add samples from audio source
-            const auto sourceChannelCount { audioSource->getChannelCount () };
-            for (auto posInSong { startSongSample }; posInSong < endSongSample; ++posInSong)
-            {
-                const auto posInBuffer { posInSong - samplePosition };
-                const auto posInSource { posInSong + offsetToPlaybackRegion };
-                if (sourceChannelCount == _channelCount)
-                {
-                    for (auto c { 0 }; c < sourceChannelCount; ++c)
-                        ppOutput[c][posInBuffer] += audioSource->getRenderSampleCacheForChannel (c)[posInSource];
-                }
-                else
-                {
-                    // crude channel format conversion:
-                    // mix down to mono, then distribute the mono signal evenly to all channels.
-                    // note that when down-mixing to mono, the result is scaled by channel count,
-                    // whereas upon up-mixing it is just copied to all channels.
-                    // \todo ambisonic formats should just stick with the mono sum on channel 0,
-                    //       but in this simple test code we currently do not distinguish ambisonics
-                    float monoSum { 0.0f };
-                    for (auto c { 0 }; c < sourceChannelCount; ++c)
-                        monoSum += audioSource->getRenderSampleCacheForChannel (c)[posInSource];
-                    if (sourceChannelCount > 1)
-                        monoSum /= static_cast<float> (sourceChannelCount);
-                    for (auto c { 0 }; c < _channelCount; ++c)
-                        ppOutput[c][posInBuffer] = monoSum;
-                }
-            }
+        // distribute the regions to the worker pool if feasible, otherwise render them here
+        if (!renderPlaybackRegionsInParallel (ppOutput, samplePosition, samplesToRender))
+        {
+            for (const auto& playbackRegion : _regionsToRender)
+                renderPlaybackRegion (playbackRegion, ppOutput, samplePosition, samplesToRender);
         }
 
         // let the document controller know we're done
@@ -116,6 +451,11 @@ void ARATestPlaybackRenderer::renderPlaybackRegions (float* const* ppOutput, ARA
     }
 }
 
+template void ARATestPlaybackRenderer::renderPlaybackRegions<float> (float* const* ppOutput, ARA::ARASamplePosition samplePosition,
+                                                                     ARA::ARASampleCount samplesToRender, bool isPlayingBack);
+template void ARATestPlaybackRenderer::renderPlaybackRegions<double> (double* const* ppOutput, ARA::ARASamplePosition samplePosition,
+                                                                      ARA::ARASampleCount samplesToRender, bool isPlayingBack);
+
 void ARATestPlaybackRenderer::enableRendering (ARA::ARASampleRate sampleRate, ARA::ARAChannelCount channelCount, ARA::ARASampleCount maxSamplesToRender, bool apiSupportsToggleRendering) noexcept
 {
     // proper plug-ins would use this call to manage the resources which they need for rendering,
@@ -123,6 +463,7 @@ void ARATestPlaybackRenderer::enableRendering (ARA::ARASampleRate sampleRate, AR
     _sampleRate = sampleRate;
     _channelCount = channelCount;
     _maxSamplesToRender = maxSamplesToRender;
+    updateRenderResources ();
 #if ARA_VALIDATE_API_CALLS
     _isRenderingEnabled = true;
     _apiSupportsToggleRendering = apiSupportsToggleRendering;
@@ -136,6 +477,122 @@ void ARATestPlaybackRenderer::disableRendering () noexcept
 #endif
 }
 
+void ARATestPlaybackRenderer::updateRenderResources () noexcept
+{
+    _resamplers.clear ();
+    decltype (_timeStretchers) timeStretchers;
+    for (const auto& playbackRegion : getPlaybackRegions ())
+    {
+        const auto audioSource { playbackRegion->getAudioModification ()->getAudioSource () };
+        const auto sourceSampleRate { audioSource->getSampleRate () };
+        if ((sourceSampleRate != _sampleRate) && !getResampler (sourceSampleRate))
+            _resamplers.emplace_back (&TestResampler::getSharedResampler (sourceSampleRate, _sampleRate, ARA_RESAMPLER_KERNEL_HALF_WIDTH));
+
+        // keep the stretch state of regions that continue to be stretched with the same configuration
+        if (isTimeStretched (playbackRegion))
+        {
+            auto timeStretcher { _timeStretchers.find (playbackRegion) };
+            if ((timeStretcher != _timeStretchers.end ()) &&
+                (timeStretcher->second->getChannelCount () == audioSource->getChannelCount ()) &&
+                (timeStretcher->second->getMaxSampleCount () == _maxSamplesToRender))
+                timeStretchers.emplace (playbackRegion, std::move (timeStretcher->second));
+            else
+                timeStretchers.emplace (playbackRegion, std::make_unique<TestTimeStretcher> (audioSource->getChannelCount (), _maxSamplesToRender));
+        }
+    }
+    _timeStretchers = std::move (timeStretchers);
+
+    // reserve space for all regions so that collecting the regions to render does not allocate
+    _regionsToRender.clear ();
+    _regionsToRender.reserve (getPlaybackRegions ().size ());
+
+#if ARA_PARALLEL_RENDERING_WORKER_THREAD_COUNT > 0
+    // a host thread pool is asked for one task per worker and manages the cores itself,
+    // whereas the internal pool uses no more worker threads than there are additional cores
+    size_t workerCount { 0 };
+    if (_hostThreadPool)
+    {
+        _workerPool.reset ();
+        workerCount = ARA_PARALLEL_RENDERING_WORKER_THREAD_COUNT + 1;
+    }
+    else
+    {
+        const auto workerThreadCount { std::min (ARA_PARALLEL_RENDERING_WORKER_THREAD_COUNT, static_cast<int> (std::thread::hardware_concurrency ()) - 1) };
+        if (!_workerPool && (workerThreadCount > 0))
+            _workerPool = TestRenderWorkerPool::getSharedPool (workerThreadCount);
+        if (_workerPool)
+            workerCount = static_cast<size_t> (_workerPool->getWorkerCount ());
+    }
+
+    const auto channelCount { static_cast<size_t> (_channelCount) };
+    const auto maxSamplesToRender { static_cast<size_t> (_maxSamplesToRender) };
+    _renderScratch.resize (workerCount);
+    for (auto& scratch : _renderScratch)
+    {
+        if ((scratch._channels32.size () == channelCount) && (scratch._samples32.size () == channelCount * maxSamplesToRender))
+            continue;
+
+        scratch._samples32.assign (channelCount * maxSamplesToRender, 0.0f);
+        scratch._samples64.assign (channelCount * maxSamplesToRender, 0.0);
+        scratch._channels32.clear ();
+        scratch._channels64.clear ();
+        for (size_t c { 0 }; c < channelCount; ++c)
+        {
+            scratch._channels32.push_back (scratch._samples32.data () + c * maxSamplesToRender);
+            scratch._channels64.push_back (scratch._samples64.data () + c * maxSamplesToRender);
+        }
+    }
+#endif
+}
+
+void ARATestPlaybackRenderer::setHostThreadPool (HostThreadPool* hostThreadPool) noexcept
+{
+#if ARA_VALIDATE_API_CALLS
+    ARA_INTERNAL_ASSERT (!_isRenderingEnabled);
+#endif
+    _hostThreadPool = hostThreadPool;
+    updateRenderResources ();
+}
+
+void ARATestPlaybackRenderer::performHostThreadPoolTask (uint32_t taskIndex) noexcept
+{
+    // only valid while renderPlaybackRegionsInParallel () is waiting for the host to execute the tasks
+    ARA_INTERNAL_ASSERT (_hostThreadPoolJob != nullptr);
+    ARA_INTERNAL_ASSERT (taskIndex < _renderScratch.size ());
+    if (!_hostThreadPoolJob)
+        return;
+
+    for (auto itemIndex { _nextHostThreadPoolItemIndex.fetch_add (1, std::memory_order_relaxed) }; itemIndex < _regionsToRender.size ();
+         itemIndex = _nextHostThreadPoolItemIndex.fetch_add (1, std::memory_order_relaxed))
+        _hostThreadPoolJob->processItem (itemIndex, static_cast<int> (taskIndex));
+}
+
+const TestResampler* ARATestPlaybackRenderer::getResampler (ARA::ARASampleRate sourceSampleRate) const noexcept
+{
+    for (const auto resampler : _resamplers)
+    {
+        if ((resampler->getSourceSampleRate () == sourceSampleRate) && (resampler->getTargetSampleRate () == _sampleRate))
+            return resampler;
+    }
+    return nullptr;
+}
+
+TestTimeStretcher* ARATestPlaybackRenderer::getTimeStretcher (const ARA::PlugIn::PlaybackRegion* playbackRegion) const noexcept
+{
+    const auto timeStretcher { _timeStretchers.find (playbackRegion) };
+    return (timeStretcher != _timeStretchers.end ()) ? timeStretcher->second.get () : nullptr;
+}
+
+void ARATestPlaybackRenderer::didAddPlaybackRegion (ARA::PlugIn::PlaybackRegion* /*playbackRegion*/) noexcept
+{
+    updateRenderResources ();
+}
+
+void ARATestPlaybackRenderer::didRemovePlaybackRegion (ARA::PlugIn::PlaybackRegion* /*playbackRegion*/) noexcept
+{
+    updateRenderResources ();
+}
+
 #if ARA_VALIDATE_API_CALLS
 void ARATestPlaybackRenderer::willAddPlaybackRegion (ARA::PlugIn::PlaybackRegion* /*playbackRegion*/) noexcept
 {
@@ -21,27 +21,101 @@
 
 #include "ARA_Library/PlugIn/ARAPlug.h"
 
+#include "TestRenderWorkerPool.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+class TestResampler;
+class TestTimeStretcher;
+
 /*******************************************************************************/
 class ARATestPlaybackRenderer : public ARA::PlugIn::PlaybackRenderer
 {
 public:
-    using PlaybackRenderer::PlaybackRenderer;
+    explicit ARATestPlaybackRenderer (ARA::PlugIn::DocumentController* documentController) noexcept;
+    ~ARATestPlaybackRenderer () override;
 
-    void renderPlaybackRegions (float* const* ppOutput, ARA::ARASamplePosition samplePosition, ARA::ARASampleCount samplesToRender, bool isPlayingBack);
+    // SampleType can be float or double, depending on the sample size negotiated by the companion API
+    template <typename SampleType>
+    void renderPlaybackRegions (SampleType* const* ppOutput, ARA::ARASamplePosition samplePosition, ARA::ARASampleCount samplesToRender, bool isPlayingBack);
 
     void enableRendering (ARA::ARASampleRate sampleRate, ARA::ARAChannelCount channelCount, ARA::ARASampleCount maxSamplesToRender, bool apiSupportsToggleRendering) noexcept;
     void disableRendering () noexcept;
 
+    // Parallel rendering uses an internal worker pool by default, but can alternatively be dispatched
+    // to a thread pool provided by the host, such as the CLAP thread-pool extension:
+    // requestExecution () is called on the render thread and must return once performHostThreadPoolTask ()
+    // has been called for each task index in [0, taskCount), on any threads - or return false
+    // if the host cannot execute the tasks, in which case the regions are rendered serially.
+    class HostThreadPool
+    {
+    public:
+        virtual ~HostThreadPool () = default;
+        virtual bool requestExecution (uint32_t taskCount) noexcept = 0;
+    };
+
+    // must be called while rendering is disabled, pass nullptr to use the internal worker pool
+    void setHostThreadPool (HostThreadPool* hostThreadPool) noexcept;
+    void performHostThreadPoolTask (uint32_t taskIndex) noexcept;
+
+    // resamplers, time stretchers and parallel rendering buffers cannot be created on the render thread,
+    // so this must be called whenever the render settings, the playback regions or their audio sources may have changed
+    void updateRenderResources () noexcept;
+
 protected:
 #if ARA_VALIDATE_API_CALLS
     void willAddPlaybackRegion (ARA::PlugIn::PlaybackRegion* playbackRegion) noexcept override;
     void willRemovePlaybackRegion (ARA::PlugIn::PlaybackRegion* playbackRegion) noexcept override;
 #endif
+    void didAddPlaybackRegion (ARA::PlugIn::PlaybackRegion* playbackRegion) noexcept override;
+    void didRemovePlaybackRegion (ARA::PlugIn::PlaybackRegion* playbackRegion) noexcept override;
+
+private:
+    // adds the samples of the given playback region that intersect with the render block to the output
+    template <typename SampleType>
+    void renderPlaybackRegion (const ARA::PlugIn::PlaybackRegion* playbackRegion, SampleType* const* ppOutput,
+                               ARA::ARASamplePosition samplePosition, ARA::ARASampleCount samplesToRender) noexcept;
+
+    // renders _regionsToRender on the worker pool, returns false if serial rendering is needed instead
+    template <typename SampleType>
+    bool renderPlaybackRegionsInParallel (SampleType* const* ppOutput, ARA::ARASamplePosition samplePosition, ARA::ARASampleCount samplesToRender) noexcept;
+
+    // returns nullptr if no resampler has been prepared for the given audio source sample rate
+    const TestResampler* getResampler (ARA::ARASampleRate sourceSampleRate) const noexcept;
+
+    // returns nullptr if the playback region is not time stretched
+    TestTimeStretcher* getTimeStretcher (const ARA::PlugIn::PlaybackRegion* playbackRegion) const noexcept;
 
 private:
     ARA::ARASampleRate _sampleRate { 44100.0f };
     ARA::ARASampleCount _maxSamplesToRender { 4096 };
     ARA::ARAChannelCount _channelCount { 1 };
+    std::vector<const TestResampler*> _resamplers;
+    std::map<const ARA::PlugIn::PlaybackRegion*, std::unique_ptr<TestTimeStretcher>> _timeStretchers;
+
+    // parallel rendering: each worker of the pool adds the regions it renders to its own scratch
+    // buffers, which are summed up into the output once all regions have been rendered
+    template <typename SampleType>
+    class ParallelRenderJob;
+    struct RenderScratch
+    {
+        template <typename SampleType>
+        SampleType* const* getChannels () noexcept;
+
+        std::vector<float> _samples32;
+        std::vector<double> _samples64;
+        std::vector<float*> _channels32;
+        std::vector<double*> _channels64;
+        bool _hasSamples { false };
+    };
+    std::shared_ptr<TestRenderWorkerPool> _workerPool;
+    HostThreadPool* _hostThreadPool { nullptr };
+    TestRenderWorkerPool::Job* _hostThreadPoolJob { nullptr };
+    std::atomic<size_t> _nextHostThreadPoolItemIndex { 0 };
+    std::vector<RenderScratch> _renderScratch;
+    std::vector<const ARA::PlugIn::PlaybackRegion*> _regionsToRender;   // capacity is reserved for all playback regions
 #if ARA_VALIDATE_API_CALLS
     bool _isRenderingEnabled { false };
     bool _apiSupportsToggleRendering { true };  // AAX enables rendering only once upon init, but does not allow to toggle it later like VST3, AU, CLAP etc.
@@ -56,6 +56,17 @@ static const clap_plugin_descriptor_t s_my_plug_desc = {
    .features = s_my_features
 };
 
+// forwards parallel rendering requests of the playback renderer to the host's thread pool
+class CLAPHostThreadPool : public ARATestPlaybackRenderer::HostThreadPool {
+public:
+   bool requestExecution(uint32_t taskCount) noexcept override {
+      return thread_pool->request_exec(host, taskCount);
+   }
+
+   const clap_host_t             *host = NULL;
+   const clap_host_thread_pool_t *thread_pool = NULL;
+};
+
 typedef struct my_plug {
    clap_plugin_t                   plugin;
    const clap_host_t              *host;
@@ -63,11 +74,14 @@ typedef struct my_plug {
    const clap_host_log_t          *host_log;
    const clap_host_thread_check_t *host_thread_check;
    const clap_host_state_t        *host_state;
+   const clap_host_thread_pool_t  *host_thread_pool;
 
    uint32_t channel_count = 1;
    double   sample_rate = 44100.0;
    uint32_t max_frames_count = 0;
 
+   CLAPHostThreadPool host_thread_pool_adapter;
+
    ARA::PlugIn::PlugInExtension ara_extension;
 } my_plug_t;
 
@@ -90,7 +104,7 @@ static bool my_plug_audio_ports_get(const clap_plugin_t    *plugin,
    info->id = 0;
    snprintf(info->name, sizeof(info->name), "%s", "My Port Name");
    info->channel_count = plug->channel_count;
-   info->flags = CLAP_AUDIO_PORT_IS_MAIN;
+   info->flags = CLAP_AUDIO_PORT_IS_MAIN | CLAP_AUDIO_PORT_SUPPORTS_64BITS;
    info->port_type = (plug->channel_count == 1) ? CLAP_PORT_MONO : (plug->channel_count == 2) ? CLAP_PORT_MONO : NULL;
    info->in_place_pair = info->id;
    return true;
@@ -184,6 +198,21 @@ static const clap_plugin_latency_t s_my_plug_latency = {
    .get = my_plug_latency_get,
 };
 
+//////////////////////
+// clap_thread_pool //
+//////////////////////
+
+static void my_plug_thread_pool_exec(const clap_plugin_t *plugin, uint32_t task_index) {
+   // called by the host's worker threads while my_plug_process() waits in request_exec()
+   my_plug_t *plug = (my_plug_t *)plugin->plugin_data;
+   if (auto *playbackRenderer = plug->ara_extension.getPlaybackRenderer<ARATestPlaybackRenderer>())
+      playbackRenderer->performHostThreadPoolTask(task_index);
+}
+
+static const clap_plugin_thread_pool_t s_my_plug_thread_pool = {
+   .exec = my_plug_thread_pool_exec,
+};
+
 ///////////////////
 // ARA extension //
 ///////////////////
@@ -218,6 +247,11 @@ static bool my_plug_init(const struct clap_plugin *plugin) {
    plug->host_thread_check = (const clap_host_thread_check_t *)plug->host->get_extension(plug->host, CLAP_EXT_THREAD_CHECK);
    plug->host_latency = (const clap_host_latency_t *)plug->host->get_extension(plug->host, CLAP_EXT_LATENCY);
    plug->host_state = (const clap_host_state_t *)plug->host->get_extension(plug->host, CLAP_EXT_STATE);
+   plug->host_thread_pool = (const clap_host_thread_pool_t *)plug->host->get_extension(plug->host, CLAP_EXT_THREAD_POOL);
+   if (plug->host_thread_pool && plug->host_thread_pool->request_exec) {
+      plug->host_thread_pool_adapter.host = plug->host;
+      plug->host_thread_pool_adapter.thread_pool = plug->host_thread_pool;
+   }
    return true;
 }
 
@@ -234,8 +268,11 @@ static bool my_plug_activate(const struct clap_plugin *plugin,
    plug->sample_rate = sample_rate;
    plug->max_frames_count = max_frames_count;
 
-   if (auto *playbackRenderer = plug->ara_extension.getPlaybackRenderer<ARATestPlaybackRenderer>())
+   if (auto *playbackRenderer = plug->ara_extension.getPlaybackRenderer<ARATestPlaybackRenderer>()) {
+      // if the host provides a thread pool, let the renderer distribute the playback regions to it
+      playbackRenderer->setHostThreadPool(plug->host_thread_pool_adapter.thread_pool ? &plug->host_thread_pool_adapter : NULL);
       playbackRenderer->enableRendering(sample_rate, (ARA::ARAChannelCount)plug->channel_count, max_frames_count, true);
+   }
 
    return true;
 }
@@ -260,18 +297,29 @@ static clap_process_status my_plug_process(const struct clap_plugin *plugin,
    if (!process->audio_outputs || !process->audio_outputs[0].channel_count)
       return CLAP_PROCESS_CONTINUE;
 
+   // since we declare CLAP_AUDIO_PORT_SUPPORTS_64BITS, the host may provide either 32 or 64 bit buffers
+   const bool use64BitSamples = (process->audio_outputs[0].data64 != NULL);
+
    auto *playbackRenderer = plug->ara_extension.getPlaybackRenderer<ARATestPlaybackRenderer>();
    if (playbackRenderer && process->transport) {   // we need transport info
       // if we're an ARA playback renderer, calculate ARA playback output
+      // (if the host provides a thread pool, the renderer requests its execution from within this call)
       const auto position = ARA::samplePositionAtTime(((double)process->transport->song_pos_seconds) / ((double)CLAP_SECTIME_FACTOR), plug->sample_rate);
-      playbackRenderer->renderPlaybackRegions(process->audio_outputs[0].data32, position, nframes,
-                                              (process->transport->flags & CLAP_TRANSPORT_IS_PLAYING) != 0);
+      const bool isPlaying = (process->transport->flags & CLAP_TRANSPORT_IS_PLAYING) != 0;
+      if (use64BitSamples)
+         playbackRenderer->renderPlaybackRegions(process->audio_outputs[0].data64, position, nframes, isPlaying);
+      else
+         playbackRenderer->renderPlaybackRegions(process->audio_outputs[0].data32, position, nframes, isPlaying);
    }
    else {
       // if we're no ARA playback renderer, we're just copying the inputs to the outputs, which is
       // appropriate both when being only an ARA editor renderer, or when being used in non-ARA mode.
-      for (uint32_t c = 0; c < process->audio_outputs[0].channel_count; ++c)
-         memcpy(process->audio_outputs[0].data32[c], process->audio_inputs[0].data32[c], sizeof(float) * nframes);
+      for (uint32_t c = 0; c < process->audio_outputs[0].channel_count; ++c) {
+         if (use64BitSamples)
+            memcpy(process->audio_outputs[0].data64[c], process->audio_inputs[0].data64[c], sizeof(double) * nframes);
+         else
+            memcpy(process->audio_outputs[0].data32[c], process->audio_inputs[0].data32[c], sizeof(float) * nframes);
+      }
    }
 
    return CLAP_PROCESS_CONTINUE;
@@ -284,6 +332,8 @@ static const void *my_plug_get_extension(const struct clap_plugin *plugin, const
       return &s_my_plug_audio_ports;
    if (!strcmp(id, CLAP_EXT_CONFIGURABLE_AUDIO_PORTS))
       return &s_my_plug_configurable_audio_ports;
+   if (!strcmp(id, CLAP_EXT_THREAD_POOL))
+      return &s_my_plug_thread_pool;
    if (!strcmp(id, CLAP_EXT_ARA_PLUGINEXTENSION))
       return &ara_plugin_extension;
    return NULL;
@@ -18,44 +18,96 @@
 
 #include "TestAnalysis.h"
 #include "TestPersistency.h"
+#include "TestFFT.h"
 
 #include "ARA_API/ARAInterface.h"
+#include "ARA_Library/Debug/ARADebug.h"
 #include "ARA_Library/Utilities/ARASamplePositionConversion.h"
 
 #include "ExamplesCommon/Utilities/StdUniquePtrUtilities.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <thread>
 #include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <tuple>
 
 // The test plug-in pretends to be able to do a kARAContentTypeNotes analysis:
 // To simulate this, it reads all samples and creates a note with invalid pitch for each range of
 // consecutive samples that are not 0. It also tracks the peak amplitude throughout each note and
 // assumes this as note volume. (Note that actual plug-ins would rather use some calculation closer
-// to RMS for determining volume.) This is no meaningful algorithm for real-world signals, but it
-// was chosen so that the resulting note data can be easily verified both manually and via scripts
-// parsing the debug output of the various examples (which generate a pulsed sine wave whenever no
-// actual audio file is used).
+// to RMS for determining volume, see ARA_FAKE_NOTE_VOLUME_MEASURE below.) This is no meaningful
+// algorithm for real-world signals, but it was chosen so that the resulting note data can be easily
+// verified both manually and via scripts parsing the debug output of the various examples (which
+// generate a pulsed sine wave whenever no actual audio file is used).
 // The time consumed by the fake analysis is the duration of the audio source scaled down by
 // ARA_FAKE_NOTE_ANALYSIS_SPEED_FACTOR - if this is set to 0, the artificial delays are supressed.
+// This only provides the default, the pacing can be changed at runtime via TestAnalysisPacing.
 #if !defined (ARA_FAKE_NOTE_ANALYSIS_SPEED_FACTOR)
     #define ARA_FAKE_NOTE_ANALYSIS_SPEED_FACTOR 20
 #endif
 
 // if desired, a custom timer for calculating the analysis delay can be injected by defining ARA_GET_CURRENT_TIME accordingly.
-#if ARA_FAKE_NOTE_ANALYSIS_SPEED_FACTOR != 0
-    #if defined (ARA_GET_CURRENT_TIME)
-        double ARA_GET_CURRENT_TIME ();    /* declare custom time getter function */
-    #else
-        #define ARA_GET_CURRENT_TIME() (0.000001 * static_cast<double> (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::high_resolution_clock::now ().time_since_epoch ()).count ()))
-    #endif
+#if defined (ARA_GET_CURRENT_TIME)
+    double ARA_GET_CURRENT_TIME ();    /* declare custom time getter function */
+#else
+    #define ARA_GET_CURRENT_TIME() (0.000001 * static_cast<double> (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::high_resolution_clock::now ().time_since_epoch ()).count ()))
 #endif
 
 #if !defined (ARA_FAKE_NOTE_MAX_COUNT)
     #define ARA_FAKE_NOTE_MAX_COUNT 100
 #endif
 
+// To overlap waiting for the host to deliver samples (which can be substantial e.g. when using IPC)
+// with the actual analysis, all algorithms read up to ARA_TEST_ANALYSIS_READ_AHEAD_DEPTH blocks
+// in advance on a separate thread - if this is set to 0, samples are read synchronously.
+#if !defined (ARA_TEST_ANALYSIS_READ_AHEAD_DEPTH)
+    #define ARA_TEST_ANALYSIS_READ_AHEAD_DEPTH 2
+#endif
+
+// The size of the blocks read from the host is adapted to the measured read throughput, see
+// PrefetchingBlockReader. For tuning, the chosen sizes can be logged by enabling ARA_TEST_ANALYSIS_LOG_BLOCK_SIZES.
+#if !defined (ARA_TEST_ANALYSIS_LOG_BLOCK_SIZES)
+    #define ARA_TEST_ANALYSIS_LOG_BLOCK_SIZES 0
+#endif
+
+// Instead of the peak amplitude, the fake analysis can optionally use the RMS level of each note or
+// its maximum short-term loudness as note volume. Both are calculated in the same pass as the note
+// detection, using running accumulators, and are expressed as linear amplitude.
+// For simplicity, the loudness calculation follows the EBU R 128 short-term loudness (3 second
+// window, updated every 100 ms) but omits the K-weighting filter and averages the channels instead
+// of summing them.
+#define ARA_FAKE_NOTE_VOLUME_PEAK 0
+#define ARA_FAKE_NOTE_VOLUME_RMS 1
+#define ARA_FAKE_NOTE_VOLUME_SHORT_TERM_LOUDNESS 2
+#if !defined (ARA_FAKE_NOTE_VOLUME_MEASURE)
+    #define ARA_FAKE_NOTE_VOLUME_MEASURE ARA_FAKE_NOTE_VOLUME_PEAK
+#endif
+
+// SIMD instruction sets used to optimize the level measurement and the YIN pitch tracker
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define ARA_TEST_ANALYSIS_USE_SSE2 1
+    #include <emmintrin.h>
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__) || defined (_M_ARM64)
+    #define ARA_TEST_ANALYSIS_USE_NEON 1
+    #include <arm_neon.h>
+#endif
+
 
 /*******************************************************************************/
 
@@ -82,14 +134,18 @@ std::unique_ptr<TestNoteContent> decodeTestNoteContent (TestUnarchiver& unarchiv
     const bool hasNoteContent { unarchiver.readBool () };
     if (hasNoteContent)
     {
+        // the note count is not trusted for allocating upfront since the data may be truncated or corrupted,
+        // instead notes are added only as long as reading succeeds
         const auto numNotes { unarchiver.readSize () };
-        result = std::make_unique<TestNoteContent> (numNotes);
-        for (TestNote& persistedNote : *result)
+        result = std::make_unique<TestNoteContent> ();
+        for (size_t i { 0 }; (i < numNotes) && unarchiver.didSucceed (); ++i)
         {
+            TestNote persistedNote;
             persistedNote._frequency = static_cast<float> (unarchiver.readDouble ());
             persistedNote._volume = static_cast<float> (unarchiver.readDouble ());
             persistedNote._startTime = unarchiver.readDouble ();
             persistedNote._duration = unarchiver.readDouble ();
+            result->push_back (persistedNote);
         }
     }
     return result;
@@ -97,224 +153,1320 @@ std::unique_ptr<TestNoteContent> decodeTestNoteContent (TestUnarchiver& unarchiv
 
 /*******************************************************************************/
 
-class PseudoAnalysisProcessingAlgorithm : public TestProcessingAlgorithm
+constexpr double TestAnalysisPacing::virtualClockTickDuration;     // prior to C++17, constexpr members that are ODR-used (e.g. by std::min ()) must be defined out-of-class
+
+static std::string getEnvironmentVariable (const char* name)
 {
-public:
-    using TestProcessingAlgorithm::TestProcessingAlgorithm;
+    std::string result;
+#if defined (_MSC_VER)
+    char* value { nullptr };
+    size_t length { 0 };
+    if ((_dupenv_s (&value, &length, name) == 0) && (value != nullptr))
+    {
+        result = value;
+        std::free (value);
+    }
+#else
+    if (const auto value { std::getenv (name) })
+        result = value;
+#endif
+    return result;
+}
 
-    std::unique_ptr<TestNoteContent> analyzeNoteContent (TestAnalysisCallbacks* analysisCallbacks, const int64_t sampleCount, const double sampleRate, const uint32_t channelCount) const noexcept override
+struct TestAnalysisPacingState
+{
+    TestAnalysisPacingState ()
     {
-        analysisCallbacks->notifyAnalysisProgressStarted ();
+        // parse "<mode>[:<speedFactor>]"
+        const auto pacing { getEnvironmentVariable ("ARA_TEST_ANALYSIS_PACING") };
+        if (pacing.empty ())
+            return;
 
-#if ARA_FAKE_NOTE_ANALYSIS_SPEED_FACTOR != 0
-        // helper variables to artificially slow down analysis as indicated by ARA_FAKE_NOTE_ANALYSIS_SPEED_FACTOR
-        const auto analysisStartTime { ARA_GET_CURRENT_TIME () };
-        const auto analysisTargetDuration { ARA::timeAtSamplePosition (sampleCount, sampleRate) / ARA_FAKE_NOTE_ANALYSIS_SPEED_FACTOR };
-#endif
+        const auto separator { pacing.find (':') };
+        const auto modeName { pacing.substr (0, separator) };
+        if (separator != std::string::npos)
+            _speedFactor = std::atof (pacing.c_str () + separator + 1);
 
-        // setup buffers and audio reader for reading samples
-        constexpr auto blockSize { 2048U };
-        std::vector<float> buffer (channelCount * blockSize);
-        std::vector<void*> dataPointers (channelCount);
-        for (auto c { 0U }; c < channelCount; ++c)
-            dataPointers[c] = &buffer[c * blockSize];
+        if (modeName == "unthrottled")
+            _mode = TestAnalysisPacing::Mode::unthrottled;
+        else if (modeName == "realtime")
+            _mode = TestAnalysisPacing::Mode::realTimeScaled;
+        else if (modeName == "virtual")
+            _mode = TestAnalysisPacing::Mode::virtualClock;
+        else
+            ARA_WARN ("ignoring invalid ARA_TEST_ANALYSIS_PACING value '%s'", pacing.c_str ());
 
-        // search the audio for silence and treat each region between silence as a note
-        int64_t blockStartIndex { 0 };
-        int64_t lastNoteStartIndex { 0 };
-        bool wasZero { true };      // samples before the start of the file are 0
-        float volume { 0.0f };
-        std::vector<TestNote> foundNotes;
-        while (true)
+        if (_speedFactor <= 0.0)
+            _mode = TestAnalysisPacing::Mode::unthrottled;
+    }
+
+    std::mutex _mutex;
+    std::condition_variable _virtualClockCondition;
+    TestAnalysisPacing::Mode _mode { (ARA_FAKE_NOTE_ANALYSIS_SPEED_FACTOR != 0) ? TestAnalysisPacing::Mode::realTimeScaled : TestAnalysisPacing::Mode::unthrottled };
+    double _speedFactor { (ARA_FAKE_NOTE_ANALYSIS_SPEED_FACTOR != 0) ? ARA_FAKE_NOTE_ANALYSIS_SPEED_FACTOR : 20.0 };
+    double _virtualTime { 0.0 };
+};
+
+static TestAnalysisPacingState& getPacingState ()
+{
+    static TestAnalysisPacingState state;
+    return state;
+}
+
+void TestAnalysisPacing::configure (const Mode mode, const double speedFactor)
+{
+    auto& state { getPacingState () };
+    std::lock_guard<std::mutex> lock { state._mutex };
+    state._mode = (speedFactor > 0.0) ? mode : Mode::unthrottled;
+    state._speedFactor = speedFactor;
+}
+
+TestAnalysisPacing::Mode TestAnalysisPacing::getMode ()
+{
+    auto& state { getPacingState () };
+    std::lock_guard<std::mutex> lock { state._mutex };
+    return state._mode;
+}
+
+void TestAnalysisPacing::advanceVirtualClock ()
+{
+    auto& state { getPacingState () };
+    {
+        std::lock_guard<std::mutex> lock { state._mutex };
+        state._virtualTime += virtualClockTickDuration;
+    }
+    state._virtualClockCondition.notify_all ();
+}
+
+// Artificially slows down an analysis as configured via TestAnalysisPacing, for testing purposes only -
+// actual plug-ins will process as fast as possible, without arbitrary waiting.
+// The pacing settings are captured when the analysis starts.
+class AnalysisPacer
+{
+public:
+    explicit AnalysisPacer (const double audioDuration)
+    {
+        auto& state { getPacingState () };
+        std::lock_guard<std::mutex> lock { state._mutex };
+        _mode = state._mode;
+        if (_mode == TestAnalysisPacing::Mode::unthrottled)
+            return;
+        _targetDuration = audioDuration / state._speedFactor;
+        _startTime = (_mode == TestAnalysisPacing::Mode::virtualClock) ? state._virtualTime : ARA_GET_CURRENT_TIME ();
+    }
+
+    bool isThrottled () const noexcept
+    {
+        return _mode != TestAnalysisPacing::Mode::unthrottled;
+    }
+
+    double getTargetDuration () const noexcept
+    {
+        return _targetDuration;
+    }
+
+    // blocks until the analysis time that corresponds to the given progress has elapsed
+    // returns false if the analysis was cancelled while waiting for the virtual clock
+    bool waitForProgress (const float progress, const TestAnalysisCallbacks* analysisCallbacks) const
+    {
+        const auto targetTime { _startTime + progress * _targetDuration };
+        switch (_mode)
         {
-            // check cancel
-            if (analysisCallbacks->shouldCancel ())
+            case TestAnalysisPacing::Mode::unthrottled:
             {
-                analysisCallbacks->notifyAnalysisProgressCompleted ();
-                return {};
+                break;
             }
-
-            // calculate size of current block and check if done
-            const auto count { std::min (static_cast<int64_t> (blockSize), sampleCount - blockStartIndex) };
-            if (count <= 0)
+            case TestAnalysisPacing::Mode::realTimeScaled:
+            {
+                const auto timeToSleep { targetTime - ARA_GET_CURRENT_TIME () };
+                if (timeToSleep > 0.0)
+                    std::this_thread::sleep_for (std::chrono::milliseconds { std::llround (timeToSleep * 1000) } );
                 break;
-
-            // read samples - note that this test code ignores any errors that the reader might return here!
-            analysisCallbacks->readAudioSamples (blockStartIndex, count, dataPointers.data ());
-
-            // analyze current block
-            for (int64_t i { 0 }; (i < count) && (foundNotes.size () < ARA_FAKE_NOTE_MAX_COUNT); ++i)
+            }
+            case TestAnalysisPacing::Mode::virtualClock:
             {
-                // check if current sample is zero on all channels
-                bool isZero { true };
-                for (int64_t c { 0 }; c < channelCount; ++c)
+                // the clock is advanced by the host, so we must periodically check for cancellation while waiting
+                auto& state { getPacingState () };
+                std::unique_lock<std::mutex> lock { state._mutex };
+                while (state._virtualTime < targetTime)
                 {
-                    const auto sample = buffer[static_cast<size_t> (i + c * blockSize)];
-                    isZero &= (sample == 0.0f);
-                    volume = std::max (volume, std::abs (sample));
+                    if (analysisCallbacks->shouldCancel ())
+                        return false;
+                    state._virtualClockCondition.wait_for (lock, std::chrono::milliseconds { 10 });
                 }
+                break;
+            }
+        }
+        return true;
+    }
 
-                // check if consecutive range of (non)zero samples ends
-                if (isZero != wasZero)
-                {
-                    wasZero = isZero;
-                    const auto index { blockStartIndex + i };
-                    if (isZero)
-                    {
-                        // found end of note - construct note
-                        const double noteStartTime { static_cast<double> (lastNoteStartIndex) / sampleRate };
-                        const double noteDuration { static_cast<double> (index - lastNoteStartIndex) / sampleRate };
-                        addNotesForSignalRange (foundNotes, volume, noteStartTime, noteDuration);
+private:
+    TestAnalysisPacing::Mode _mode;
+    double _targetDuration { 0.0 };
+    double _startTime { 0.0 };
+};
 
-                        volume = 0.0f;
-                    }
-                    else
-                    {
-                        // found start of note - store start index
-                        lastNoteStartIndex = index;
-                    }
-                }
-            }
+/*******************************************************************************/
 
-            // go to next block and set progress
-            // (in the progress calculation, we're scaling by 0.999 to account for the time needed
-            // to store the result after this loop has completed)
-            blockStartIndex += count;
-            const float progress { 0.999f * static_cast<float> (blockStartIndex) / static_cast<float> (sampleCount) };
-            analysisCallbacks->notifyAnalysisProgressUpdated (progress);
+// Returns sum (samples[i]^2), using pairwise summation to keep rounding errors low for large counts.
+// The SSE2 or NEON lanes of the leaf blocks act as four independent partial sums.
+static float sumOfSquares (const float* samples, const size_t count) noexcept
+{
+    constexpr size_t pairwiseLeafSize { 128 };
+    if (count > pairwiseLeafSize)
+    {
+        const auto half { count / 2 };
+        return sumOfSquares (samples, half) + sumOfSquares (samples + half, count - half);
+    }
 
-#if ARA_FAKE_NOTE_ANALYSIS_SPEED_FACTOR != 0
-            // for testing purposes only, sleep here until dummy analysis time has elapsed -
-            // actual plug-ins will process as fast as possible, without arbitrary sleeping
-            const auto analysisTargetTime { analysisStartTime + progress * analysisTargetDuration };
-            const auto timeToSleep { analysisTargetTime - ARA_GET_CURRENT_TIME () };
-            if (timeToSleep > 0.0)
-                std::this_thread::sleep_for (std::chrono::milliseconds { std::llround (timeToSleep * 1000) } );
+    size_t i { 0 };
+    float result { 0.0f };
+#if ARA_TEST_ANALYSIS_USE_SSE2 || ARA_TEST_ANALYSIS_USE_NEON
+    const auto vectorizedCount { count - count % 4 };
 #endif
-        }
-
-        if (!wasZero)
-        {
-            // last note continued until the end of the audio source - construct last note
-            const double noteStartTime { static_cast<double> (lastNoteStartIndex) / sampleRate };
-            const double noteDuration { static_cast<double> (sampleCount - lastNoteStartIndex) / sampleRate };
-            addNotesForSignalRange (foundNotes, volume, noteStartTime, noteDuration);
-        }
+#if ARA_TEST_ANALYSIS_USE_SSE2
+    __m128 sum { _mm_setzero_ps () };
+    for (; i < vectorizedCount; i += 4)
+    {
+        const __m128 values { _mm_loadu_ps (samples + i) };
+        sum = _mm_add_ps (sum, _mm_mul_ps (values, values));
+    }
+    alignas (16) float lanes[4];
+    _mm_store_ps (lanes, sum);
+    result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif ARA_TEST_ANALYSIS_USE_NEON
+    float32x4_t sum { vdupq_n_f32 (0.0f) };
+    for (; i < vectorizedCount; i += 4)
+    {
+        const float32x4_t values { vld1q_f32 (samples + i) };
+        sum = vmlaq_f32 (sum, values, values);
+    }
+    float lanes[4];
+    vst1q_f32 (lanes, sum);
+    result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+    for (; i < count; ++i)
+        result += samples[i] * samples[i];
+    return result;
+}
 
-        // complete analysis and store result
-        analysisCallbacks->notifyAnalysisProgressCompleted ();
-        return std::make_unique<TestNoteContent> (foundNotes);
+// Kahan summation, so that accumulating many block sums does not lose precision for long notes.
+class CompensatedSum
+{
+public:
+    void add (double value) noexcept
+    {
+        const auto compensatedValue { value - _compensation };
+        const auto newSum { _sum + compensatedValue };
+        _compensation = (newSum - _sum) - compensatedValue;
+        _sum = newSum;
     }
 
-protected:
-    virtual void addNotesForSignalRange (TestNoteContent& foundNotes, const float volume, const double startTime, const double duration) const = 0;
+    double getSum () const noexcept { return _sum; }
+
+private:
+    double _sum { 0.0 };
+    double _compensation { 0.0 };
 };
 
 /*******************************************************************************/
 
-static const
-class PercussiveProcessingAlgorithm : public PseudoAnalysisProcessingAlgorithm
+// block sizes used for reading the samples: reading starts with analysisBlockSize samples to
+// quickly provide initial progress, and may grow up to maxAnalysisBlockSize (see PrefetchingBlockReader)
+constexpr int64_t analysisBlockSize { 2048 };
+constexpr int64_t maxAnalysisBlockSize { 32768 };
+
+// a block of samples read from the host, stored per channel
+class SampleBlock
 {
 public:
-    PercussiveProcessingAlgorithm ()
-    : PseudoAnalysisProcessingAlgorithm { "Percussive", "org.ara-audio.examples.testplugin.algorithm.percussive" }
-    {}
+    SampleBlock (const uint32_t channelCount, const int64_t capacity)
+    : _capacity { capacity },
+      _samples (static_cast<size_t> (channelCount * capacity)),
+      _dataPointers (channelCount)
+    {
+        for (auto c { 0U }; c < channelCount; ++c)
+            _dataPointers[c] = &_samples[static_cast<size_t> (c * capacity)];
+    }
 
-protected:
-    void addNotesForSignalRange (TestNoteContent& foundNotes, const float volume, const double startTime, const double duration) const override
+    int64_t getStartSample () const noexcept { return _startSample; }
+    int64_t getSampleCount () const noexcept { return _sampleCount; }
+    const float* getChannelSamples (const uint32_t channel) const noexcept { return static_cast<const float*> (_dataPointers[channel]); }
+
+    bool read (TestAnalysisCallbacks* analysisCallbacks, const int64_t startSample, const int64_t sampleCount)
     {
-        foundNotes.emplace_back (TestNote { ARA::kARAInvalidFrequency, volume, startTime, duration });
+        ARA_INTERNAL_ASSERT (sampleCount <= _capacity);
+        _startSample = startSample;
+        _sampleCount = sampleCount;
+        return analysisCallbacks->readAudioSamples (startSample, sampleCount, _dataPointers.data ());
     }
-} percussiveAlgorithm;
 
-/*******************************************************************************/
+private:
+    const int64_t _capacity;
+    std::vector<float> _samples;
+    std::vector<void*> _dataPointers;
+    int64_t _startSample { 0 };
+    int64_t _sampleCount { 0 };
+};
 
-static const
-class MonophonicProcessingAlgorithm : public PseudoAnalysisProcessingAlgorithm
+// Running accumulators for RMS and short-term loudness of a note, fed with the note's samples
+// block by block while streaming through the audio.
+class NoteLevelMeter
 {
 public:
-    MonophonicProcessingAlgorithm ()
-    : PseudoAnalysisProcessingAlgorithm { "Monophonic", "org.ara-audio.examples.testplugin.algorithm.monophonic" }
+    NoteLevelMeter (const double sampleRate, const uint32_t channelCount)
+    : _channelCount { channelCount },
+      _hopSize { std::max<int64_t> (1, ARA::samplePositionAtTime (0.1, sampleRate)) }
     {}
 
-protected:
-    void addNotesForSignalRange (TestNoteContent& foundNotes, const float volume, const double startTime, const double duration) const override
+    void reset () noexcept
     {
-        foundNotes.emplace_back (TestNote { 440.0f, volume, startTime, duration }); // standard tuning A
+        _totalEnergy = CompensatedSum {};
+        _totalSampleCount = 0;
+        _hopEnergy = 0.0;
+        _hopSampleCount = 0;
+        _completedHopCount = 0;
+        _maxWindowMeanSquare = 0.0;
     }
-} monophonicAlgorithm;
 
-/*******************************************************************************/
+    // adds the samples [startIndex, endIndex) of the given block
+    void addSamples (const SampleBlock& block, int64_t startIndex, const int64_t endIndex) noexcept
+    {
+        while (startIndex < endIndex)
+        {
+            const auto count { std::min (endIndex - startIndex, _hopSize - _hopSampleCount) };
+            double energy { 0.0 };
+            for (auto c { 0U }; c < _channelCount; ++c)
+                energy += sumOfSquares (block.getChannelSamples (c) + startIndex, static_cast<size_t> (count));
 
-static const
-class PolyphonicProcessingAlgorithm : public PseudoAnalysisProcessingAlgorithm
-{
-public:
-    PolyphonicProcessingAlgorithm ()
-    : PseudoAnalysisProcessingAlgorithm { "Polyphonic", "org.ara-audio.examples.testplugin.algorithm.polyphonic" }
-    {}
+            _totalEnergy.add (energy);
+            _totalSampleCount += count;
+            _hopEnergy += energy;
+            _hopSampleCount += count;
+            startIndex += count;
 
-protected:
-    void addNotesForSignalRange (TestNoteContent& foundNotes, const float volume, const double startTime, const double duration) const override
+            if (_hopSampleCount == _hopSize)
+            {
+                _hopEnergies[_completedHopCount % windowHopCount] = _hopEnergy;
+                ++_completedHopCount;
+                _hopEnergy = 0.0;
+                _hopSampleCount = 0;
+                _maxWindowMeanSquare = std::max (_maxWindowMeanSquare, getCurrentWindowMeanSquare ());
+            }
+        }
+    }
+
+    float getRMS () const noexcept
     {
-        foundNotes.emplace_back (TestNote { 523.2511f, volume, startTime, duration });  // standard tuning C
-        foundNotes.emplace_back (TestNote { 659.2551f, volume, startTime, duration });  // standard tuning E
+        if (_totalSampleCount == 0)
+            return 0.0f;
+        return static_cast<float> (std::sqrt (_totalEnergy.getSum () / static_cast<double> (_totalSampleCount * _channelCount)));
     }
-} polyphonicAlgorithm;
 
-/*******************************************************************************/
+    // the loudness of notes shorter than the window is calculated across the entire note
+    float getShortTermLoudness () const noexcept
+    {
+        return static_cast<float> (std::sqrt (std::max (_maxWindowMeanSquare, getCurrentWindowMeanSquare ())));
+    }
 
-static const
-class SingleNoteProcessingAlgorithm : public TestProcessingAlgorithm
+private:
+    // mean square across the most recent hops (including the pending partial hop) spanning up to the window duration
+    double getCurrentWindowMeanSquare () const noexcept
+    {
+        auto windowEnergy { _hopEnergy };
+        auto windowSampleCount { _hopSampleCount };
+        const auto windowCompletedHopCount { std::min (_completedHopCount, (_hopSampleCount > 0) ? windowHopCount - 1 : windowHopCount) };
+        for (auto i { 1U }; i <= windowCompletedHopCount; ++i)
+        {
+            windowEnergy += _hopEnergies[(_completedHopCount - i) % windowHopCount];
+            windowSampleCount += _hopSize;
+        }
+        if (windowSampleCount == 0)
+            return 0.0;
+        return windowEnergy / static_cast<double> (windowSampleCount * _channelCount);
+    }
+
+    static constexpr size_t windowHopCount { 30 };      // 3 second window, updated every 100 ms
+
+    const uint32_t _channelCount;
+    const int64_t _hopSize;
+    CompensatedSum _totalEnergy;
+    int64_t _totalSampleCount { 0 };
+    double _hopEnergy { 0.0 };
+    int64_t _hopSampleCount { 0 };
+    double _hopEnergies[windowHopCount] {};
+    size_t _completedHopCount { 0 };
+    double _maxWindowMeanSquare { 0.0 };
+};
+
+constexpr size_t NoteLevelMeter::windowHopCount;
+
+// Reads the consecutive blocks of samples covering [startSample, endSample), prefetching up to
+// readAheadDepth blocks on a helper thread while the previous block is analyzed.
+// Note that the host audio reader is only ever used by one thread at a time, as required by ARA.
+// The block size starts small for quick initial progress, and is doubled as long as this improves
+// the read throughput by a meaningful amount: larger blocks amortize the per-call overhead of the
+// host's reader, which can be substantial e.g. when using IPC or when reading from disk.
+class PrefetchingBlockReader
 {
 public:
-    SingleNoteProcessingAlgorithm ()
-    : TestProcessingAlgorithm { "Single Note", "org.ara-audio.examples.testplugin.algorithm.singlenote" }
-    {}
-
-    std::unique_ptr<TestNoteContent> analyzeNoteContent (TestAnalysisCallbacks* analysisCallbacks, const int64_t sampleCount, const double sampleRate, uint32_t /*channelCount*/) const override
+    PrefetchingBlockReader (TestAnalysisCallbacks* analysisCallbacks, const uint32_t channelCount, const int64_t startSample, const int64_t endSample, const size_t readAheadDepth)
+    : _analysisCallbacks { analysisCallbacks },
+      _endSample { endSample },
+      _nextReadPosition { startSample }
     {
-        analysisCallbacks->notifyAnalysisProgressStarted ();
+        _blocks.reserve (readAheadDepth + 1);
+        for (auto i { 0U }; i < readAheadDepth + 1; ++i)
+            _blocks.emplace_back (channelCount, maxAnalysisBlockSize);
 
-#if ARA_FAKE_NOTE_ANALYSIS_SPEED_FACTOR != 0
-        // for testing purposes only, sleep here until dummy analysis time has elapsed
-        const auto analysisTargetDuration { ARA::timeAtSamplePosition (sampleCount, sampleRate) / ARA_FAKE_NOTE_ANALYSIS_SPEED_FACTOR };
-        constexpr auto sliceDuration { 0.05 };
-        const auto count { (analysisTargetDuration > sliceDuration) ? static_cast<int> (analysisTargetDuration / sliceDuration + 0.5) : 1 };
-        for (auto i { 0 }; i < count; ++i)
+        if (readAheadDepth > 0)
+            _prefetchThread = std::thread { [this] () { prefetchBlocks (); } };
+    }
+
+    ~PrefetchingBlockReader ()
+    {
+        if (_prefetchThread.joinable ())
         {
-            // check cancel
-            if (analysisCallbacks->shouldCancel ())
             {
-                analysisCallbacks->notifyAnalysisProgressCompleted ();
-                return {};
+                std::lock_guard<std::mutex> lock { _mutex };
+                _shouldStop = true;
             }
+            _condition.notify_all ();
+            _prefetchThread.join ();
+        }
+    }
+
+    // returns the next block - it remains valid until the next call
+    // must only be called while the previous blocks did not reach endSample yet
+    const SampleBlock& readNextBlock ()
+    {
+        const auto blockIndex { _nextBlockIndex++ };
+        auto& block { getBlock (blockIndex) };
+        if (!_prefetchThread.joinable ())
+        {
+            readBlock (block);
+            return block;
+        }
+
+        // release the previous block to the prefetch thread, then wait until the requested block is available
+        std::unique_lock<std::mutex> lock { _mutex };
+        _releasedBlockCount = blockIndex;
+        _condition.notify_all ();
+        _condition.wait (lock, [this, blockIndex] () { return _readBlockCount > blockIndex; });
+        return block;
+    }
+
+private:
+    SampleBlock& getBlock (const size_t blockIndex)
+    {
+        return _blocks[blockIndex % _blocks.size ()];
+    }
+
+    // note that this test code ignores any errors that the reader might return here!
+    void readBlock (SampleBlock& block)
+    {
+        const auto sampleCount { std::min (_blockSize, _endSample - _nextReadPosition) };
+        const auto readStartTime { std::chrono::steady_clock::now () };
+        block.read (_analysisCallbacks, _nextReadPosition, sampleCount);
+        const auto readDuration { std::chrono::duration<double> (std::chrono::steady_clock::now () - readStartTime).count () };
+        _nextReadPosition += sampleCount;
 
-            analysisCallbacks->notifyAnalysisProgressUpdated (static_cast<float> (i) / static_cast<float> (count));
-            std::this_thread::sleep_for (std::chrono::milliseconds { std::llround (sliceDuration * 1000) } );
+        // the last block may be truncated and thus does not provide a valid measurement
+        if (_isGrowingBlockSize && (sampleCount == _blockSize))
+            adaptBlockSize (readDuration);
+    }
+
+    void adaptBlockSize (const double readDuration)
+    {
+        const auto throughput { static_cast<double> (_blockSize) / std::max (readDuration, 1.0e-9) };
+        if ((_blockSize < maxAnalysisBlockSize) && (throughput > minThroughputGain * _bestThroughput))
+        {
+            _bestThroughput = throughput;
+            _blockSize *= 2;
+#if ARA_TEST_ANALYSIS_LOG_BLOCK_SIZES
+            ARA_LOG ("analysis read %.3f ms per call, %.0f samples per second - increasing block size to %lli samples", 1000.0 * readDuration, throughput, static_cast<long long> (_blockSize));
+#endif
         }
+        else
+        {
+            _isGrowingBlockSize = false;
+#if ARA_TEST_ANALYSIS_LOG_BLOCK_SIZES
+            ARA_LOG ("analysis read %.3f ms per call, %.0f samples per second - keeping block size of %lli samples", 1000.0 * readDuration, throughput, static_cast<long long> (_blockSize));
 #endif
+        }
+    }
 
-        TestNote foundNote { ARA::kARAInvalidFrequency, 1.0f, 0.0, ARA::timeAtSamplePosition (sampleCount, sampleRate) };
-        analysisCallbacks->notifyAnalysisProgressCompleted ();
-        return std::make_unique<TestNoteContent> (std::vector<TestNote> { foundNote });
+    void prefetchBlocks ()
+    {
+        for (size_t blockIndex { 0 }; _nextReadPosition < _endSample; ++blockIndex)
+        {
+            // wait until the buffer for this block is no longer in use by the analysis
+            {
+                std::unique_lock<std::mutex> lock { _mutex };
+                _condition.wait (lock, [this, blockIndex] () { return _shouldStop || (blockIndex < _releasedBlockCount + _blocks.size ()); });
+                if (_shouldStop)
+                    return;
+            }
+
+            readBlock (getBlock (blockIndex));
+
+            {
+                std::lock_guard<std::mutex> lock { _mutex };
+                _readBlockCount = blockIndex + 1;
+            }
+            _condition.notify_all ();
+        }
     }
-} singleNoteAlgorithm;
+
+    static constexpr double minThroughputGain { 1.1 };
+
+    TestAnalysisCallbacks* const _analysisCallbacks;
+    const int64_t _endSample;
+    std::vector<SampleBlock> _blocks;
+    size_t _nextBlockIndex { 0 };
+
+    // only accessed by the thread reading the samples
+    int64_t _nextReadPosition;
+    int64_t _blockSize { analysisBlockSize };
+    bool _isGrowingBlockSize { true };
+    double _bestThroughput { 0.0 };
+
+    std::thread _prefetchThread;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    size_t _readBlockCount { 0 };       // blocks [0, _readBlockCount) have been read
+    size_t _releasedBlockCount { 0 };   // blocks [0, _releasedBlockCount) have been analyzed, their buffers can be reused
+    bool _shouldStop { false };
+};
 
 /*******************************************************************************/
 
-std::vector<const TestProcessingAlgorithm*> const& TestProcessingAlgorithm::getAlgorithms ()
+class PseudoAnalysisProcessingAlgorithm : public TestProcessingAlgorithm
 {
-    static const std::vector<const TestProcessingAlgorithm*> algorithms { &percussiveAlgorithm, &monophonicAlgorithm, &polyphonicAlgorithm, &singleNoteAlgorithm };
-    return algorithms;
-}
+public:
+    using TestProcessingAlgorithm::TestProcessingAlgorithm;
 
-const TestProcessingAlgorithm* TestProcessingAlgorithm::getDefaultAlgorithm ()
-{
-    return &percussiveAlgorithm;
-}
+    std::unique_ptr<TestNoteContent> analyzeNoteContent (TestAnalysisCallbacks* analysisCallbacks, const int64_t sampleCount, const double sampleRate, const uint32_t channelCount) const noexcept override
+    {
+        analysisCallbacks->notifyAnalysisProgressStarted ();
 
-const TestProcessingAlgorithm* TestProcessingAlgorithm::getAlgorithmWithIdentifier (const char* identifier)
+        std::vector<TestNote> foundNotes;
+        const bool didComplete { analyzeSampleRange (analysisCallbacks, sampleRate, channelCount, 0, sampleCount, ARA_FAKE_NOTE_MAX_COUNT, foundNotes) };
+
+        // complete analysis and store result
+        analysisCallbacks->notifyAnalysisProgressCompleted ();
+        if (!didComplete)
+            return {};
+        return std::make_unique<TestNoteContent> (foundNotes);
+    }
+
+    // Since notes are separated by silence, it is sufficient to re-scan the changed samples extended
+    // to the surrounding silence: the silent samples at the borders are unchanged, so no previous note
+    // can extend across them, and all notes outside of the extended range remain valid.
+    std::unique_ptr<TestNoteContent> reanalyzeNoteContent (TestAnalysisCallbacks* analysisCallbacks, const int64_t sampleCount, const double sampleRate, const uint32_t channelCount,
+                                                           const TestNoteContent& previousContent, int64_t& startSample, int64_t& endSample) const noexcept override
+    {
+        analysisCallbacks->notifyAnalysisProgressStarted ();
+
+        // if the samples around the changed range cannot be read, fall back to re-analyzing the entire audio source
+        if (!findSilenceBefore (analysisCallbacks, channelCount, startSample) ||
+            !findSilenceAfter (analysisCallbacks, channelCount, sampleCount, endSample))
+        {
+            startSample = 0;
+            endSample = sampleCount;
+        }
+
+        // keep all previous notes outside of the re-analyzed range, and re-scan the notes inside of it
+        const auto isBeforeRange { [startSample, sampleRate] (const TestNote& note) { return ARA::samplePositionAtTime (note._startTime, sampleRate) < startSample; } };
+        const auto isAfterRange { [endSample, sampleRate] (const TestNote& note) { return ARA::samplePositionAtTime (note._startTime, sampleRate) >= endSample; } };
+        const auto keptNotesCount { static_cast<size_t> (std::count_if (previousContent.begin (), previousContent.end (), isBeforeRange) +
+                                                         std::count_if (previousContent.begin (), previousContent.end (), isAfterRange)) };
+        const auto maxNoteCount { (keptNotesCount < ARA_FAKE_NOTE_MAX_COUNT) ? ARA_FAKE_NOTE_MAX_COUNT - keptNotesCount : 0 };
+
+        std::vector<TestNote> foundNotes;
+        const bool didComplete { analyzeSampleRange (analysisCallbacks, sampleRate, channelCount, startSample, endSample, maxNoteCount, foundNotes) };
+
+        analysisCallbacks->notifyAnalysisProgressCompleted ();
+        if (!didComplete)
+            return {};
+
+        auto result { std::make_unique<TestNoteContent> () };
+        result->reserve (keptNotesCount + foundNotes.size ());
+        std::copy_if (previousContent.begin (), previousContent.end (), std::back_inserter (*result), isBeforeRange);
+        result->insert (result->end (), foundNotes.begin (), foundNotes.end ());
+        std::copy_if (previousContent.begin (), previousContent.end (), std::back_inserter (*result), isAfterRange);
+        return result;
+    }
+
+private:
+    static bool isSilentSample (const std::vector<float>& buffer, const int64_t index, const uint32_t channelCount)
+    {
+        for (auto c { 0U }; c < channelCount; ++c)
+        {
+            if (buffer[static_cast<size_t> (index + c * analysisBlockSize)] != 0.0f)
+                return false;
+        }
+        return true;
+    }
+
+    // moves samplePosition back to the start of the signal containing it, i.e. the position after the last preceding silent sample
+    // returns false if reading the samples failed, leaving samplePosition unchanged
+    static bool findSilenceBefore (TestAnalysisCallbacks* analysisCallbacks, const uint32_t channelCount, int64_t& samplePosition)
+    {
+        std::vector<float> buffer (channelCount * analysisBlockSize);
+        std::vector<void*> dataPointers (channelCount);
+        for (auto c { 0U }; c < channelCount; ++c)
+            dataPointers[c] = &buffer[c * analysisBlockSize];
+
+        auto blockEndIndex { samplePosition };
+        while (blockEndIndex > 0)
+        {
+            const auto count { std::min (analysisBlockSize, blockEndIndex) };
+            if (!analysisCallbacks->readAudioSamples (blockEndIndex - count, count, dataPointers.data ()))
+                return false;
+            for (auto i { count - 1 }; i >= 0; --i)
+            {
+                if (isSilentSample (buffer, i, channelCount))
+                {
+                    samplePosition = blockEndIndex - count + i + 1;
+                    return true;
+                }
+            }
+            blockEndIndex -= count;
+        }
+        samplePosition = 0;
+        return true;
+    }
+
+    // moves samplePosition forward to the first silent sample at or after it, or to the sample count if there is none
+    // returns false if reading the samples failed, leaving samplePosition unchanged
+    static bool findSilenceAfter (TestAnalysisCallbacks* analysisCallbacks, const uint32_t channelCount, const int64_t sampleCount, int64_t& samplePosition)
+    {
+        std::vector<float> buffer (channelCount * analysisBlockSize);
+        std::vector<void*> dataPointers (channelCount);
+        for (auto c { 0U }; c < channelCount; ++c)
+            dataPointers[c] = &buffer[c * analysisBlockSize];
+
+        auto blockStartIndex { samplePosition };
+        while (blockStartIndex < sampleCount)
+        {
+            const auto count { std::min (analysisBlockSize, sampleCount - blockStartIndex) };
+            if (!analysisCallbacks->readAudioSamples (blockStartIndex, count, dataPointers.data ()))
+                return false;
+            for (int64_t i { 0 }; i < count; ++i)
+            {
+                if (isSilentSample (buffer, i, channelCount))
+                {
+                    samplePosition = blockStartIndex + i;
+                    return true;
+                }
+            }
+            blockStartIndex += count;
+        }
+        samplePosition = sampleCount;
+        return true;
+    }
+
+    // scans the samples in [startSample, endSample) for notes - the samples directly before and after
+    // the range must be silent (or outside of the audio source)
+    // returns false if the analysis was cancelled
+    bool analyzeSampleRange (TestAnalysisCallbacks* analysisCallbacks, const double sampleRate, const uint32_t channelCount,
+                             const int64_t startSample, const int64_t endSample, const size_t maxNoteCount, std::vector<TestNote>& foundNotes) const noexcept
+    {
+        // helper to artificially slow down analysis as configured via TestAnalysisPacing
+        const AnalysisPacer pacer { ARA::timeAtSamplePosition (endSample - startSample, sampleRate) };
+
+        // setup reader for the samples
+        PrefetchingBlockReader blockReader { analysisCallbacks, channelCount, startSample, endSample, ARA_TEST_ANALYSIS_READ_AHEAD_DEPTH };
+
+        // search the audio for silence and treat each region between silence as a note
+        int64_t blockStartIndex { startSample };
+        int64_t lastNoteStartIndex { startSample };
+        bool wasZero { true };      // samples before the start of the range are 0
+        float volume { 0.0f };
+#if ARA_FAKE_NOTE_VOLUME_MEASURE != ARA_FAKE_NOTE_VOLUME_PEAK
+        NoteLevelMeter levelMeter { sampleRate, channelCount };
+        const auto getNoteVolume { [&levelMeter] ()
+        {
+    #if ARA_FAKE_NOTE_VOLUME_MEASURE == ARA_FAKE_NOTE_VOLUME_RMS
+            return levelMeter.getRMS ();
+    #else
+            return levelMeter.getShortTermLoudness ();
+    #endif
+        } };
+#endif
+        while (true)
+        {
+            // check cancel
+            if (analysisCallbacks->shouldCancel ())
+                return false;
+
+            // check if done, otherwise read next block
+            if (blockStartIndex >= endSample)
+                break;
+            const auto& block { blockReader.readNextBlock () };
+            const auto count { block.getSampleCount () };
+
+            // analyze current block
+#if ARA_FAKE_NOTE_VOLUME_MEASURE != ARA_FAKE_NOTE_VOLUME_PEAK
+            int64_t levelMeterStartIndex { 0 };    // start of the samples of the current note not yet added to levelMeter
+#endif
+            for (int64_t i { 0 }; (i < count) && (foundNotes.size () < maxNoteCount); ++i)
+            {
+                // check if current sample is zero on all channels
+                bool isZero { true };
+                for (int64_t c { 0 }; c < channelCount; ++c)
+                {
+                    const auto sample = block.getChannelSamples (static_cast<uint32_t> (c))[i];
+                    isZero &= (sample == 0.0f);
+                    volume = std::max (volume, std::abs (sample));
+                }
+
+                // check if consecutive range of (non)zero samples ends
+                if (isZero != wasZero)
+                {
+                    wasZero = isZero;
+                    const auto index { blockStartIndex + i };
+                    if (isZero)
+                    {
+                        // found end of note - construct note
+#if ARA_FAKE_NOTE_VOLUME_MEASURE != ARA_FAKE_NOTE_VOLUME_PEAK
+                        levelMeter.addSamples (block, levelMeterStartIndex, i);
+                        volume = getNoteVolume ();
+#endif
+                        const double noteStartTime { static_cast<double> (lastNoteStartIndex) / sampleRate };
+                        const double noteDuration { static_cast<double> (index - lastNoteStartIndex) / sampleRate };
+                        addNotesForSignalRange (foundNotes, volume, noteStartTime, noteDuration);
+
+                        volume = 0.0f;
+                    }
+                    else
+                    {
+                        // found start of note - store start index
+                        lastNoteStartIndex = index;
+#if ARA_FAKE_NOTE_VOLUME_MEASURE != ARA_FAKE_NOTE_VOLUME_PEAK
+                        levelMeter.reset ();
+                        levelMeterStartIndex = i;
+#endif
+                    }
+                }
+            }
+#if ARA_FAKE_NOTE_VOLUME_MEASURE != ARA_FAKE_NOTE_VOLUME_PEAK
+            if (!wasZero)
+                levelMeter.addSamples (block, levelMeterStartIndex, count);
+#endif
+
+            // go to next block and set progress
+            // (in the progress calculation, we're scaling by 0.999 to account for the time needed
+            // to store the result after this loop has completed)
+            blockStartIndex += count;
+            const float progress { 0.999f * static_cast<float> (blockStartIndex - startSample) / static_cast<float> (endSample - startSample) };
+            analysisCallbacks->notifyAnalysisProgressUpdated (progress);
+
+            // for testing purposes only, wait here until dummy analysis time has elapsed
+            if (!pacer.waitForProgress (progress, analysisCallbacks))
+                return false;
+        }
+
+        if (!wasZero)
+        {
+            // last note continued until the end of the range - construct last note
+#if ARA_FAKE_NOTE_VOLUME_MEASURE != ARA_FAKE_NOTE_VOLUME_PEAK
+            volume = getNoteVolume ();
+#endif
+            const double noteStartTime { static_cast<double> (lastNoteStartIndex) / sampleRate };
+            const double noteDuration { static_cast<double> (endSample - lastNoteStartIndex) / sampleRate };
+            addNotesForSignalRange (foundNotes, volume, noteStartTime, noteDuration);
+        }
+
+        return true;
+    }
+
+protected:
+    virtual void addNotesForSignalRange (TestNoteContent& foundNotes, const float volume, const double startTime, const double duration) const = 0;
+};
+
+/*******************************************************************************/
+
+static const
+class PercussiveProcessingAlgorithm : public PseudoAnalysisProcessingAlgorithm
+{
+public:
+    PercussiveProcessingAlgorithm ()
+    : PseudoAnalysisProcessingAlgorithm { "Percussive", "org.ara-audio.examples.testplugin.algorithm.percussive" }
+    {}
+
+protected:
+    void addNotesForSignalRange (TestNoteContent& foundNotes, const float volume, const double startTime, const double duration) const override
+    {
+        foundNotes.emplace_back (TestNote { ARA::kARAInvalidFrequency, volume, startTime, duration });
+    }
+} percussiveAlgorithm;
+
+/*******************************************************************************/
+
+static const
+class MonophonicProcessingAlgorithm : public PseudoAnalysisProcessingAlgorithm
+{
+public:
+    MonophonicProcessingAlgorithm ()
+    : PseudoAnalysisProcessingAlgorithm { "Monophonic", "org.ara-audio.examples.testplugin.algorithm.monophonic" }
+    {}
+
+protected:
+    void addNotesForSignalRange (TestNoteContent& foundNotes, const float volume, const double startTime, const double duration) const override
+    {
+        foundNotes.emplace_back (TestNote { 440.0f, volume, startTime, duration }); // standard tuning A
+    }
+} monophonicAlgorithm;
+
+/*******************************************************************************/
+
+static const
+class PolyphonicProcessingAlgorithm : public PseudoAnalysisProcessingAlgorithm
+{
+public:
+    PolyphonicProcessingAlgorithm ()
+    : PseudoAnalysisProcessingAlgorithm { "Polyphonic", "org.ara-audio.examples.testplugin.algorithm.polyphonic" }
+    {}
+
+protected:
+    void addNotesForSignalRange (TestNoteContent& foundNotes, const float volume, const double startTime, const double duration) const override
+    {
+        foundNotes.emplace_back (TestNote { 523.2511f, volume, startTime, duration });  // standard tuning C
+        foundNotes.emplace_back (TestNote { 659.2551f, volume, startTime, duration });  // standard tuning E
+    }
+} polyphonicAlgorithm;
+
+/*******************************************************************************/
+
+// Helper for the analysis algorithms that operate on a mono mixdown: reads consecutive samples
+// beginning at startPosition and averages all channels, prefetching them via a PrefetchingBlockReader.
+// Samples before 0 or at or after sampleCount are set to zero.
+class MonoSampleReader
+{
+public:
+    MonoSampleReader (TestAnalysisCallbacks* analysisCallbacks, int64_t sampleCount, uint32_t channelCount, int64_t startPosition)
+    : _sampleCount { sampleCount },
+      _channelCount { channelCount },
+      _position { startPosition },
+      _blockReader { analysisCallbacks, channelCount, std::min (std::max<int64_t> (0, startPosition), sampleCount), sampleCount, ARA_TEST_ANALYSIS_READ_AHEAD_DEPTH }
+    {}
+
+    // reads the next count samples
+    void read (size_t count, float* destination)
+    {
+        while (count > 0)
+        {
+            size_t chunkSize { count };
+            if (_position < 0)
+            {
+                chunkSize = static_cast<size_t> (std::min<int64_t> (static_cast<int64_t> (count), -_position));
+                std::fill (destination, destination + chunkSize, 0.0f);
+            }
+            else if (_position >= _sampleCount)
+            {
+                std::fill (destination, destination + chunkSize, 0.0f);
+            }
+            else
+            {
+                if ((_block == nullptr) || (_blockOffset == static_cast<size_t> (_block->getSampleCount ())))
+                {
+                    _block = &_blockReader.readNextBlock ();
+                    _blockOffset = 0;
+                }
+
+                chunkSize = std::min (count, static_cast<size_t> (_block->getSampleCount ()) - _blockOffset);
+                for (auto i { 0U }; i < chunkSize; ++i)
+                {
+                    float sum { 0.0f };
+                    for (auto c { 0U }; c < _channelCount; ++c)
+                        sum += _block->getChannelSamples (c)[_blockOffset + i];
+                    destination[i] = sum / static_cast<float> (_channelCount);
+                }
+                _blockOffset += chunkSize;
+            }
+
+            destination += chunkSize;
+            count -= chunkSize;
+            _position += static_cast<int64_t> (chunkSize);
+        }
+    }
+
+private:
+    const int64_t _sampleCount;
+    const uint32_t _channelCount;
+    int64_t _position;
+    PrefetchingBlockReader _blockReader;
+    const SampleBlock* _block { nullptr };
+    size_t _blockOffset { 0 };
+};
+
+// Helper for the inner loop of the YIN difference function: returns sum ((a[i] - b[i])^2).
+// This is where most of the analysis time is spent, so it is vectorized for SSE2 or NEON where available.
+static float sumOfSquaredDifferences (const float* a, const float* b, const size_t count) noexcept
+{
+    size_t i { 0 };
+    float result { 0.0f };
+#if ARA_TEST_ANALYSIS_USE_SSE2 || ARA_TEST_ANALYSIS_USE_NEON
+    const auto vectorizedCount { count - count % 4 };
+#endif
+#if ARA_TEST_ANALYSIS_USE_SSE2
+    __m128 sum { _mm_setzero_ps () };
+    for (; i < vectorizedCount; i += 4)
+    {
+        const __m128 difference { _mm_sub_ps (_mm_loadu_ps (a + i), _mm_loadu_ps (b + i)) };
+        sum = _mm_add_ps (sum, _mm_mul_ps (difference, difference));
+    }
+    alignas (16) float lanes[4];
+    _mm_store_ps (lanes, sum);
+    result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif ARA_TEST_ANALYSIS_USE_NEON
+    float32x4_t sum { vdupq_n_f32 (0.0f) };
+    for (; i < vectorizedCount; i += 4)
+    {
+        const float32x4_t difference { vsubq_f32 (vld1q_f32 (a + i), vld1q_f32 (b + i)) };
+        sum = vmlaq_f32 (sum, difference, difference);
+    }
+    float lanes[4];
+    vst1q_f32 (lanes, sum);
+    result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+    for (; i < count; ++i)
+    {
+        const auto difference { a[i] - b[i] };
+        result += difference * difference;
+    }
+    return result;
+}
+
+// Monophonic pitch tracker based on the YIN algorithm (de Cheveigne & Kawahara, 2002):
+// For each analysis frame, the cumulative mean normalized difference function is calculated
+// and the first lag below a threshold is used as period estimate. Consecutive voiced frames
+// with a stable pitch are combined into notes.
+// Unlike the pseudo analysis algorithms, this performs actual (CPU-bound) signal processing,
+// so it does not apply any artificial delays.
+static const
+class YinPitchProcessingAlgorithm : public TestProcessingAlgorithm
+{
+public:
+    YinPitchProcessingAlgorithm ()
+    : TestProcessingAlgorithm { "Pitch Tracking (YIN)", "org.ara-audio.examples.testplugin.algorithm.yinpitch" }
+    {}
+
+    std::unique_ptr<TestNoteContent> analyzeNoteContent (TestAnalysisCallbacks* analysisCallbacks, const int64_t sampleCount, const double sampleRate, const uint32_t channelCount) const override
+    {
+        analysisCallbacks->notifyAnalysisProgressStarted ();
+
+        // the lag range covers the pitches we're looking for, the frame needs to contain the integration window plus the maximum lag
+        const auto minLag { std::max<size_t> (2, static_cast<size_t> (sampleRate / maxFrequency)) };
+        const auto maxLag { std::max (minLag + 1, std::min (integrationWindowSize, static_cast<size_t> (sampleRate / minFrequency))) };
+        const auto frameSize { integrationWindowSize + maxLag };
+
+        // mono mixdown of the current frame, which is shifted by hopSize for each analysis step
+        std::vector<float> frame (frameSize);
+        MonoSampleReader sampleReader { analysisCallbacks, sampleCount, channelCount, 0 };
+        sampleReader.read (frameSize, frame.data ());
+
+        std::vector<float> differences (maxLag + 1);
+        std::vector<TestNote> foundNotes;
+        NoteTracker noteTracker { foundNotes, sampleRate };
+        for (int64_t frameStart { 0 }; (frameStart < sampleCount) && (foundNotes.size () < ARA_FAKE_NOTE_MAX_COUNT); frameStart += static_cast<int64_t> (hopSize))
+        {
+            if (analysisCallbacks->shouldCancel ())
+            {
+                analysisCallbacks->notifyAnalysisProgressCompleted ();
+                return {};
+            }
+
+            noteTracker.addFrame (frameStart, estimateFrequency (frame, differences, minLag, maxLag, sampleRate), getPeakAmplitude (frame));
+
+            // shift frame and read next hop
+            std::copy (frame.begin () + static_cast<ptrdiff_t> (hopSize), frame.end (), frame.begin ());
+            sampleReader.read (hopSize, &frame[frameSize - hopSize]);
+
+            analysisCallbacks->notifyAnalysisProgressUpdated (0.999f * static_cast<float> (frameStart) / static_cast<float> (sampleCount));
+        }
+        noteTracker.finishNote (std::min (sampleCount, ((sampleCount + static_cast<int64_t> (hopSize) - 1) / static_cast<int64_t> (hopSize)) * static_cast<int64_t> (hopSize)));
+
+        analysisCallbacks->notifyAnalysisProgressCompleted ();
+        return std::make_unique<TestNoteContent> (foundNotes);
+    }
+
+private:
+    static constexpr size_t hopSize { 512 };
+    static constexpr size_t integrationWindowSize { 1024 };
+    static constexpr double minFrequency { 55.0 };      // A1
+    static constexpr double maxFrequency { 1760.0 };    // A6
+    static constexpr float yinThreshold { 0.15f };
+    static constexpr float silenceThreshold { 0.001f };
+
+    static float getPeakAmplitude (const std::vector<float>& frame)
+    {
+        float peak { 0.0f };
+        for (auto i { 0U }; i < integrationWindowSize; ++i)
+            peak = std::max (peak, std::abs (frame[i]));
+        return peak;
+    }
+
+    // returns ARA::kARAInvalidFrequency if the frame is silent or unvoiced
+    static float estimateFrequency (const std::vector<float>& frame, std::vector<float>& differences, const size_t minLag, const size_t maxLag, const double sampleRate)
+    {
+        if (getPeakAmplitude (frame) < silenceThreshold)
+            return ARA::kARAInvalidFrequency;
+
+        // difference function, normalized by its cumulative mean
+        differences[0] = 1.0f;
+        float runningSum { 0.0f };
+        for (auto lag { 1U }; lag <= maxLag; ++lag)
+        {
+            const auto difference { sumOfSquaredDifferences (frame.data (), frame.data () + lag, integrationWindowSize) };
+            runningSum += difference;
+            differences[lag] = (runningSum > 0.0f) ? difference * static_cast<float> (lag) / runningSum : 1.0f;
+        }
+
+        // find first dip below threshold, then follow it down to its local minimum
+        auto lag { minLag };
+        while ((lag < maxLag) && (differences[lag] >= yinThreshold))
+            ++lag;
+        if (lag >= maxLag)
+            return ARA::kARAInvalidFrequency;
+        while ((lag + 1 < maxLag) && (differences[lag + 1] < differences[lag]))
+            ++lag;
+
+        // refine period via parabolic interpolation
+        auto period { static_cast<double> (lag) };
+        const auto previous { differences[lag - 1] };
+        const auto current { differences[lag] };
+        const auto next { differences[lag + 1] };
+        const auto denominator { previous - 2.0f * current + next };
+        if (denominator > 0.0f)
+            period += 0.5 * static_cast<double> (previous - next) / static_cast<double> (denominator);
+        return static_cast<float> (sampleRate / period);
+    }
+
+    // combines consecutive frames with a stable pitch into notes
+    class NoteTracker
+    {
+    public:
+        NoteTracker (std::vector<TestNote>& foundNotes, double sampleRate)
+        : _foundNotes { foundNotes },
+          _sampleRate { sampleRate }
+        {}
+
+        void addFrame (int64_t frameStart, float frequency, float volume)
+        {
+            if (_frameCount > 0)
+            {
+                // continue note if the pitch deviates by less than a semitone from the note's average pitch
+                const auto averageFrequency { _frequencySum / static_cast<float> (_frameCount) };
+                if ((frequency != ARA::kARAInvalidFrequency) && (std::abs (12.0f * std::log2 (frequency / averageFrequency)) < 1.0f))
+                {
+                    _frequencySum += frequency;
+                    _volume = std::max (_volume, volume);
+                    ++_frameCount;
+                    return;
+                }
+                finishNote (frameStart);
+            }
+
+            if (frequency != ARA::kARAInvalidFrequency)
+            {
+                _noteStart = frameStart;
+                _frequencySum = frequency;
+                _volume = volume;
+                _frameCount = 1;
+            }
+        }
+
+        void finishNote (int64_t noteEnd)
+        {
+            if (_frameCount == 0)
+                return;
+
+            const auto frequency { _frequencySum / static_cast<float> (_frameCount) };
+            _foundNotes.emplace_back (TestNote { frequency, _volume, static_cast<double> (_noteStart) / _sampleRate, static_cast<double> (noteEnd - _noteStart) / _sampleRate });
+            _frameCount = 0;
+        }
+
+    private:
+        std::vector<TestNote>& _foundNotes;
+        const double _sampleRate;
+        int64_t _noteStart { 0 };
+        float _frequencySum { 0.0f };
+        float _volume { 0.0f };
+        int _frameCount { 0 };
+    };
+} yinPitchAlgorithm;
+
+// prior to C++17, constexpr members that are ODR-used (e.g. by std::min ()) must be defined out-of-class
+constexpr size_t YinPitchProcessingAlgorithm::hopSize;
+constexpr size_t YinPitchProcessingAlgorithm::integrationWindowSize;
+
+// Polyphonic analysis based on spectral peak picking:
+// For each Hann-windowed analysis frame, the magnitude spectrum is calculated via FFT and the
+// strongest local maxima are used as pitch candidates, skipping peaks that are likely overtones
+// of lower peaks. Candidates are mapped to the nearest semitone, and notes are tracked per
+// semitone across frames.
+// The FFT plan is shared read-only between all analysis threads, while each thread reuses
+// its own scratch buffers across analysis runs.
+// Like the YIN algorithm, this performs actual signal processing and does not apply any artificial delays.
+static const
+class SpectralPeaksProcessingAlgorithm : public TestProcessingAlgorithm
+{
+public:
+    SpectralPeaksProcessingAlgorithm ()
+    : TestProcessingAlgorithm { "Polyphonic Spectral Peaks (FFT)", "org.ara-audio.examples.testplugin.algorithm.spectralpeaks" }
+    {}
+
+    std::unique_ptr<TestNoteContent> analyzeNoteContent (TestAnalysisCallbacks* analysisCallbacks, const int64_t sampleCount, const double sampleRate, const uint32_t channelCount) const override
+    {
+        analysisCallbacks->notifyAnalysisProgressStarted ();
+
+        const auto& fft { TestFFT::getSharedPlan (fftSize) };
+        const auto& window { fft.getHannWindow () };
+        const auto magnitudeScale { 2.0f / fft.getHannWindowSum () };   // a sine with amplitude 1 yields a peak magnitude of 1
+
+        // analysis is never nested on a given thread, so the scratch buffers can be reused without further synchronization
+        static thread_local AnalysisScratch scratch;
+        scratch._frame.assign (fftSize, 0.0f);
+        scratch._windowedFrame.resize (fftSize);
+        scratch._spectrum.resize (fftSize / 2 + 1);
+        scratch._magnitudes.resize (fftSize / 2 + 1);
+
+        // frames are centered around multiples of hopSize, the first frame starts before sample 0
+        MonoSampleReader sampleReader { analysisCallbacks, sampleCount, channelCount, -static_cast<int64_t> (fftSize / 2) };
+        sampleReader.read (fftSize, scratch._frame.data ());
+
+        std::vector<TestNote> foundNotes;
+        std::map<int, ActiveNote> activeNotes;
+        const auto finishNote { [&foundNotes, sampleRate] (const ActiveNote& note, int64_t noteEnd)
+        {
+            // ignore spurious peaks caused by spectral leakage at onsets and offsets
+            if (note._frameCount < minNoteFrameCount)
+                return;
+
+            const auto frequency { note._frequencySum / static_cast<float> (note._frameCount) };
+            foundNotes.emplace_back (TestNote { frequency, note._volume, static_cast<double> (note._start) / sampleRate, static_cast<double> (noteEnd - note._start) / sampleRate });
+        } };
+
+        for (int64_t frameCenter { 0 }; (frameCenter < sampleCount) && (foundNotes.size () < ARA_FAKE_NOTE_MAX_COUNT); frameCenter += static_cast<int64_t> (hopSize))
+        {
+            if (analysisCallbacks->shouldCancel ())
+            {
+                analysisCallbacks->notifyAnalysisProgressCompleted ();
+                return {};
+            }
+
+            for (auto i { 0U }; i < fftSize; ++i)
+                scratch._windowedFrame[i] = scratch._frame[i] * window[i];
+            fft.perform (scratch._windowedFrame.data (), scratch._spectrum.data (), scratch._fftScratch);
+            for (auto i { 0U }; i < scratch._spectrum.size (); ++i)
+                scratch._magnitudes[i] = magnitudeScale * std::abs (scratch._spectrum[i]);
+            findPeaks (scratch, sampleRate);
+
+            // end all notes no longer present, then continue or start notes for each peak
+            const auto frameStart { std::max<int64_t> (0, frameCenter - static_cast<int64_t> (hopSize / 2)) };
+            for (auto it { activeNotes.begin () }; it != activeNotes.end ();)
+            {
+                if (std::none_of (scratch._peaks.begin (), scratch._peaks.end (), [it] (const Peak& peak) { return peak._pitch == it->first; }))
+                {
+                    finishNote (it->second, frameStart);
+                    it = activeNotes.erase (it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+            for (const auto& peak : scratch._peaks)
+            {
+                auto& note { activeNotes[peak._pitch] };
+                if (note._frameCount == 0)
+                    note._start = frameStart;
+                note._frequencySum += peak._frequency;
+                note._volume = std::max (note._volume, peak._magnitude);
+                ++note._frameCount;
+            }
+
+            // shift frame and read next hop
+            std::copy (scratch._frame.begin () + static_cast<ptrdiff_t> (hopSize), scratch._frame.end (), scratch._frame.begin ());
+            sampleReader.read (hopSize, &scratch._frame[fftSize - hopSize]);
+
+            analysisCallbacks->notifyAnalysisProgressUpdated (0.999f * static_cast<float> (frameCenter) / static_cast<float> (sampleCount));
+        }
+        for (const auto& activeNote : activeNotes)
+            finishNote (activeNote.second, sampleCount);
+
+        std::stable_sort (foundNotes.begin (), foundNotes.end (), [] (const TestNote& a, const TestNote& b) { return a._startTime < b._startTime; });
+
+        analysisCallbacks->notifyAnalysisProgressCompleted ();
+        return std::make_unique<TestNoteContent> (foundNotes);
+    }
+
+private:
+    static constexpr size_t fftSize { 4096 };
+    static constexpr size_t hopSize { 1024 };
+    static constexpr double minFrequency { 55.0 };      // A1
+    static constexpr double maxFrequency { 4186.0 };    // C8
+    static constexpr size_t maxPolyphony { 6 };
+    static constexpr size_t maxCandidates { 16 };
+    static constexpr int minNoteFrameCount { 2 };
+    static constexpr float relativePeakThreshold { 0.1f };
+    static constexpr float silenceThreshold { 0.001f };
+
+    struct Peak
+    {
+        float _frequency;
+        float _magnitude;
+        int _pitch;         // nearest MIDI pitch
+    };
+
+    struct ActiveNote
+    {
+        int64_t _start { 0 };
+        float _frequencySum { 0.0f };
+        float _volume { 0.0f };
+        int _frameCount { 0 };
+    };
+
+    struct AnalysisScratch
+    {
+        std::vector<float> _frame;
+        std::vector<float> _windowedFrame;
+        std::vector<TestFFT::Complex> _spectrum;
+        std::vector<float> _magnitudes;
+        std::vector<Peak> _candidates;
+        std::vector<Peak> _peaks;
+        TestFFT::Scratch _fftScratch;
+    };
+
+    static void findPeaks (AnalysisScratch& scratch, const double sampleRate)
+    {
+        const auto& magnitudes { scratch._magnitudes };
+        auto& candidates { scratch._candidates };
+        auto& peaks { scratch._peaks };
+        candidates.clear ();
+        peaks.clear ();
+
+        const auto binsPerHertz { static_cast<double> (fftSize) / sampleRate };
+        const auto minBin { std::max<size_t> (2, static_cast<size_t> (std::ceil (minFrequency * binsPerHertz))) };
+        const auto maxBin { std::min (magnitudes.size () - 3, static_cast<size_t> (maxFrequency * binsPerHertz)) };
+        if (minBin > maxBin)
+            return;
+
+        const auto frameMax { *std::max_element (magnitudes.begin () + static_cast<ptrdiff_t> (minBin), magnitudes.begin () + static_cast<ptrdiff_t> (maxBin) + 1) };
+        const auto threshold { std::max (silenceThreshold, relativePeakThreshold * frameMax) };
+        for (auto bin { minBin }; bin <= maxBin; ++bin)
+        {
+            const auto magnitude { magnitudes[bin] };
+            if ((magnitude < threshold) ||
+                (magnitude <= magnitudes[bin - 1]) || (magnitude <= magnitudes[bin - 2]) ||
+                (magnitude < magnitudes[bin + 1]) || (magnitude < magnitudes[bin + 2]))
+                continue;
+
+            // refine frequency via parabolic interpolation of the log magnitudes
+            const auto previous { std::log (std::max (magnitudes[bin - 1], 1e-12f)) };
+            const auto current { std::log (magnitude) };
+            const auto next { std::log (std::max (magnitudes[bin + 1], 1e-12f)) };
+            const auto denominator { previous - 2.0f * current + next };
+            const auto offset { (denominator < 0.0f) ? 0.5f * (previous - next) / denominator : 0.0f };
+            const auto frequency { static_cast<float> ((static_cast<double> (bin) + offset) / binsPerHertz) };
+            const auto pitch { static_cast<int> (std::lround (69.0 + 12.0 * std::log2 (frequency / 440.0))) };
+            candidates.emplace_back (Peak { frequency, magnitude, pitch });
+        }
+
+        // keep strongest candidates, then accept them from low to high while skipping overtones and duplicate pitches
+        if (candidates.size () > maxCandidates)
+        {
+            std::partial_sort (candidates.begin (), candidates.begin () + maxCandidates, candidates.end (), [] (const Peak& a, const Peak& b) { return a._magnitude > b._magnitude; });
+            candidates.resize (maxCandidates);
+        }
+        std::sort (candidates.begin (), candidates.end (), [] (const Peak& a, const Peak& b) { return a._frequency < b._frequency; });
+        for (const auto& candidate : candidates)
+        {
+            const auto isOvertoneOrDuplicate { std::any_of (peaks.begin (), peaks.end (), [&candidate] (const Peak& peak)
+            {
+                if (peak._pitch == candidate._pitch)
+                    return true;
+                const auto ratio { candidate._frequency / peak._frequency };
+                const auto harmonic { std::round (ratio) };
+                return (harmonic >= 2.0f) && (std::abs (1200.0f * std::log2 (ratio / harmonic)) < 30.0f);
+            }) };
+            if (isOvertoneOrDuplicate)
+                continue;
+            peaks.push_back (candidate);
+            if (peaks.size () == maxPolyphony)
+                break;
+        }
+    }
+} spectralPeaksAlgorithm;
+
+constexpr size_t SpectralPeaksProcessingAlgorithm::maxCandidates;
+constexpr float SpectralPeaksProcessingAlgorithm::silenceThreshold;
+
+/*******************************************************************************/
+
+static const
+class SingleNoteProcessingAlgorithm : public TestProcessingAlgorithm
+{
+public:
+    SingleNoteProcessingAlgorithm ()
+    : TestProcessingAlgorithm { "Single Note", "org.ara-audio.examples.testplugin.algorithm.singlenote" }
+    {}
+
+    std::unique_ptr<TestNoteContent> analyzeNoteContent (TestAnalysisCallbacks* analysisCallbacks, const int64_t sampleCount, const double sampleRate, uint32_t /*channelCount*/) const override
+    {
+        analysisCallbacks->notifyAnalysisProgressStarted ();
+
+        // for testing purposes only, wait here until dummy analysis time has elapsed
+        const AnalysisPacer pacer { ARA::timeAtSamplePosition (sampleCount, sampleRate) };
+        if (pacer.isThrottled ())
+        {
+            constexpr auto sliceDuration { 0.05 };
+            const auto count { (pacer.getTargetDuration () > sliceDuration) ? static_cast<int> (pacer.getTargetDuration () / sliceDuration + 0.5) : 1 };
+            for (auto i { 0 }; i < count; ++i)
+            {
+                // check cancel
+                if (analysisCallbacks->shouldCancel ())
+                {
+                    analysisCallbacks->notifyAnalysisProgressCompleted ();
+                    return {};
+                }
+
+                analysisCallbacks->notifyAnalysisProgressUpdated (static_cast<float> (i) / static_cast<float> (count));
+                pacer.waitForProgress (static_cast<float> (i + 1) / static_cast<float> (count), analysisCallbacks);
+            }
+        }
+
+        TestNote foundNote { ARA::kARAInvalidFrequency, 1.0f, 0.0, ARA::timeAtSamplePosition (sampleCount, sampleRate) };
+        analysisCallbacks->notifyAnalysisProgressCompleted ();
+        return std::make_unique<TestNoteContent> (std::vector<TestNote> { foundNote });
+    }
+} singleNoteAlgorithm;
+
+/*******************************************************************************/
+
+std::vector<const TestProcessingAlgorithm*> const& TestProcessingAlgorithm::getAlgorithms ()
+{
+    static const std::vector<const TestProcessingAlgorithm*> algorithms { &percussiveAlgorithm, &monophonicAlgorithm, &polyphonicAlgorithm, &singleNoteAlgorithm, &yinPitchAlgorithm, &spectralPeaksAlgorithm };
+    return algorithms;
+}
+
+const TestProcessingAlgorithm* TestProcessingAlgorithm::getDefaultAlgorithm ()
+{
+    return &percussiveAlgorithm;
+}
+
+std::unique_ptr<TestNoteContent> TestProcessingAlgorithm::reanalyzeNoteContent (TestAnalysisCallbacks* analysisCallbacks, const int64_t sampleCount, const double sampleRate, const uint32_t channelCount,
+                                                                               const TestNoteContent& /*previousContent*/, int64_t& startSample, int64_t& endSample) const
+{
+    startSample = 0;
+    endSample = sampleCount;
+    return analyzeNoteContent (analysisCallbacks, sampleCount, sampleRate, channelCount);
+}
+
+const TestProcessingAlgorithm* TestProcessingAlgorithm::getAlgorithmWithIdentifier (const char* identifier)
 {
     const auto begin { getAlgorithms ().begin () };
     const auto end { getAlgorithms ().end () };
@@ -322,3 +1474,742 @@ const TestProcessingAlgorithm* TestProcessingAlgorithm::getAlgorithmWithIdentifi
                                                     { return std::strcmp (algorithm->getIdentifier (), identifier) == 0; } ) };
     return (it != end) ? *it : nullptr;
 }
+
+/*******************************************************************************/
+
+// Serves the sample reads of several concurrently running analyses from a shared window of blocks,
+// so that each block is read from the host only once. A dedicated reader thread reads the blocks
+// sequentially and appends them to the window, blocks are dropped as soon as all analyses have moved
+// past them - to limit memory consumption, the reader thread waits for the slowest analysis when the
+// window has reached sharedStreamMaxBlockCount blocks.
+// Reads outside of the window (i.e. non-sequential access) are forwarded to the host.
+// All host reads are serialized, as required by ARA.
+constexpr size_t sharedStreamMaxBlockCount { 16 };
+
+class SharedSampleStream
+{
+public:
+    // adapter that is passed to each analysis instead of the original callbacks
+    class Consumer : public TestAnalysisCallbacks
+    {
+    public:
+        Consumer (SharedSampleStream& stream, size_t consumerIndex)
+        : _stream { stream },
+          _consumerIndex { consumerIndex }
+        {}
+
+        // started and completed are notified once for all analyses by analyzeNoteContentWithAlgorithms ()
+        void notifyAnalysisProgressUpdated (float progress) noexcept override
+        {
+            _stream.updateProgress (_consumerIndex, progress);
+        }
+
+        bool readAudioSamples (int64_t samplePosition, int64_t samplesPerChannel, void* const buffers[]) noexcept override
+        {
+            return _stream.readAudioSamples (_consumerIndex, samplePosition, samplesPerChannel, buffers);
+        }
+
+        bool shouldCancel () const noexcept override
+        {
+            return _stream._analysisCallbacks->shouldCancel ();
+        }
+
+    private:
+        SharedSampleStream& _stream;
+        const size_t _consumerIndex;
+    };
+
+    SharedSampleStream (TestAnalysisCallbacks* analysisCallbacks, const int64_t sampleCount, const uint32_t channelCount, const size_t consumerCount)
+    : _analysisCallbacks { analysisCallbacks },
+      _sampleCount { sampleCount },
+      _channelCount { channelCount },
+      _consumerPositions (consumerCount, 0),
+      _consumerProgress (consumerCount, 0.0f),
+      _readerThread { [this] () { readBlocks (); } }
+    {}
+
+    ~SharedSampleStream ()
+    {
+        {
+            std::lock_guard<std::mutex> lock { _mutex };
+            _shouldStop = true;
+        }
+        _condition.notify_all ();
+        _readerThread.join ();
+    }
+
+    // must be called when a consumer is done, so that it no longer holds back dropping blocks
+    void finishConsumer (const size_t consumerIndex)
+    {
+        {
+            std::lock_guard<std::mutex> lock { _mutex };
+            _consumerPositions[consumerIndex] = std::numeric_limits<int64_t>::max ();
+            dropConsumedBlocks ();
+            _consumerProgress[consumerIndex] = 1.0f;
+            notifyAverageProgress ();
+        }
+        _condition.notify_all ();
+    }
+
+private:
+    // runs on the reader thread until all samples have been read, reading fails, or the analysis is cancelled
+    void readBlocks ()
+    {
+        std::unique_lock<std::mutex> lock { _mutex };
+        while (_windowEndPosition < _sampleCount)
+        {
+            _condition.wait (lock, [this] () { return _shouldStop || (_blocks.size () < sharedStreamMaxBlockCount); });
+            if (_shouldStop || _analysisCallbacks->shouldCancel ())
+                break;
+
+            std::unique_ptr<SampleBlock> block;
+            if (_unusedBlocks.empty ())
+            {
+                block = std::make_unique<SampleBlock> (_channelCount, maxAnalysisBlockSize);
+            }
+            else
+            {
+                block = std::move (_unusedBlocks.back ());
+                _unusedBlocks.pop_back ();
+            }
+
+            // the block is not part of the window yet, so it can be filled without blocking the consumers
+            const auto startSample { _windowEndPosition };
+            lock.unlock ();
+            bool success;
+            {
+                std::lock_guard<std::mutex> hostReadLock { _hostReadMutex };
+                success = block->read (_analysisCallbacks, startSample, std::min (maxAnalysisBlockSize, _sampleCount - startSample));
+            }
+            lock.lock ();
+
+            if (!success)
+                break;
+            _windowEndPosition += block->getSampleCount ();
+            _blocks.emplace_back (std::move (block));
+            _condition.notify_all ();
+        }
+
+        // wake up any consumers still waiting for samples that will no longer be read
+        _isReadingStopped = true;
+        _condition.notify_all ();
+    }
+
+    bool readAudioSamples (const size_t consumerIndex, const int64_t samplePosition, const int64_t samplesPerChannel, void* const buffers[])
+    {
+        std::unique_lock<std::mutex> lock { _mutex };
+
+        const auto endPosition { samplePosition + samplesPerChannel };
+        if ((samplePosition < _windowStartPosition) || (endPosition > _sampleCount))
+        {
+            lock.unlock ();
+            std::lock_guard<std::mutex> hostReadLock { _hostReadMutex };
+            return _analysisCallbacks->readAudioSamples (samplePosition, samplesPerChannel, buffers);
+        }
+
+        // the consumer no longer needs any samples before the requested range, which allows for
+        // dropping blocks if it skips ahead - then wait until the reader thread has provided the range
+        _consumerPositions[consumerIndex] = std::max (_consumerPositions[consumerIndex], samplePosition);
+        dropConsumedBlocks ();
+        _condition.notify_all ();
+        _condition.wait (lock, [this, endPosition] () { return _isReadingStopped || (_windowEndPosition >= endPosition); });
+        if (_windowEndPosition < endPosition)
+            return false;
+
+        // copy the requested range from the blocks that overlap it
+        for (const auto& block : _blocks)
+        {
+            const auto copyStart { std::max (samplePosition, block->getStartSample ()) };
+            const auto copyEnd { std::min (endPosition, block->getStartSample () + block->getSampleCount ()) };
+            if (copyStart >= copyEnd)
+                continue;
+            for (auto c { 0U }; c < _channelCount; ++c)
+                std::memcpy (static_cast<float*> (buffers[c]) + (copyStart - samplePosition), block->getChannelSamples (c) + (copyStart - block->getStartSample ()),
+                             static_cast<size_t> (copyEnd - copyStart) * sizeof (float));
+        }
+
+        _consumerPositions[consumerIndex] = endPosition;
+        dropConsumedBlocks ();
+        lock.unlock ();
+        _condition.notify_all ();
+        return true;
+    }
+
+    void updateProgress (const size_t consumerIndex, const float progress)
+    {
+        std::lock_guard<std::mutex> lock { _mutex };
+        _consumerProgress[consumerIndex] = progress;
+        notifyAverageProgress ();
+    }
+
+    // must be called with _mutex locked
+    void notifyAverageProgress ()
+    {
+        float progressSum { 0.0f };
+        for (const auto consumerProgress : _consumerProgress)
+            progressSum += consumerProgress;
+        _analysisCallbacks->notifyAnalysisProgressUpdated (progressSum / static_cast<float> (_consumerProgress.size ()));
+    }
+
+    // must be called with _mutex locked
+    void dropConsumedBlocks ()
+    {
+        const auto minConsumerPosition { *std::min_element (_consumerPositions.begin (), _consumerPositions.end ()) };
+        while (!_blocks.empty () && (_blocks.front ()->getStartSample () + _blocks.front ()->getSampleCount () <= minConsumerPosition))
+        {
+            _windowStartPosition += _blocks.front ()->getSampleCount ();
+            _unusedBlocks.emplace_back (std::move (_blocks.front ()));
+            _blocks.pop_front ();
+        }
+    }
+
+    TestAnalysisCallbacks* const _analysisCallbacks;
+    const int64_t _sampleCount;
+    const uint32_t _channelCount;
+
+    std::mutex _hostReadMutex;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque<std::unique_ptr<SampleBlock>> _blocks;
+    std::vector<std::unique_ptr<SampleBlock>> _unusedBlocks;
+    int64_t _windowStartPosition { 0 };
+    int64_t _windowEndPosition { 0 };
+    bool _isReadingStopped { false };
+    bool _shouldStop { false };
+    std::vector<int64_t> _consumerPositions;    // end of the most recent read of each consumer
+    std::vector<float> _consumerProgress;
+    std::thread _readerThread;                  // must be initialized last, since it accesses all other members
+};
+
+std::vector<std::unique_ptr<TestNoteContent>> TestProcessingAlgorithm::analyzeNoteContentWithAlgorithms (const std::vector<const TestProcessingAlgorithm*>& algorithms,
+                                                                                                         TestAnalysisCallbacks* analysisCallbacks, const int64_t sampleCount, const double sampleRate, const uint32_t channelCount)
+{
+    std::vector<std::unique_ptr<TestNoteContent>> results;
+    if (algorithms.empty ())
+        return results;
+
+    analysisCallbacks->notifyAnalysisProgressStarted ();
+
+    SharedSampleStream stream { analysisCallbacks, sampleCount, channelCount, algorithms.size () };
+    const auto analyze { [&] (size_t algorithmIndex)
+    {
+        SharedSampleStream::Consumer consumer { stream, algorithmIndex };
+        auto result { algorithms[algorithmIndex]->analyzeNoteContent (&consumer, sampleCount, sampleRate, channelCount) };
+        stream.finishConsumer (algorithmIndex);
+        return result;
+    } };
+
+    // the first algorithm runs on the calling thread, all others on separate threads
+    std::vector<std::future<std::unique_ptr<TestNoteContent>>> futures;
+    for (size_t i { 1 }; i < algorithms.size (); ++i)
+        futures.emplace_back (std::async (std::launch::async, analyze, i));
+    results.emplace_back (analyze (0));
+    for (auto& future : futures)
+        results.emplace_back (future.get ());
+
+    analysisCallbacks->notifyAnalysisProgressCompleted ();
+    return results;
+}
+
+std::vector<const TestProcessingAlgorithm*> TestProcessingAlgorithm::getSinglePassAlgorithms ()
+{
+    std::vector<const TestProcessingAlgorithm*> algorithms;
+    const auto identifiers { getEnvironmentVariable ("ARA_TEST_ANALYSIS_SINGLE_PASS_ALGORITHMS") };
+    for (size_t start { 0 }; start < identifiers.size ();)
+    {
+        const auto separator { std::min (identifiers.find (',', start), identifiers.size ()) };
+        const auto identifier { identifiers.substr (start, separator - start) };
+        start = separator + 1;
+        if (identifier.empty ())
+            continue;
+
+        const auto algorithm { getAlgorithmWithIdentifier (identifier.c_str ()) };
+        if (!algorithm)
+            ARA_WARN ("ignoring unknown algorithm '%s' in ARA_TEST_ANALYSIS_SINGLE_PASS_ALGORITHMS", identifier.c_str ());
+        else if (std::find (algorithms.begin (), algorithms.end (), algorithm) == algorithms.end ())
+            algorithms.push_back (algorithm);
+    }
+    return algorithms;
+}
+
+/*******************************************************************************/
+
+// the fingerprint is calculated reading blocks of this many samples
+constexpr int64_t cacheKeyBlockSize { 16 * 1024 };
+
+// to limit memory consumption, the oldest results are dropped when exceeding this count
+constexpr size_t cacheMaxEntryCount { 64 };
+
+// Analysis results can also be persisted to a local directory, so that restarting the host does not
+// require re-analyzing audio that has been analyzed before. The directory can be chosen at runtime
+// via the environment variable ARA_TEST_ANALYSIS_CACHE_DIRECTORY (or TestAnalysisCache::setPersistentDirectory ()),
+// and its size is limited to ARA_PERSISTENT_ANALYSIS_CACHE_MAX_SIZE bytes, evicting least recently used entries.
+#if !defined (ARA_PERSISTENT_ANALYSIS_CACHE_MAX_SIZE)
+    #define ARA_PERSISTENT_ANALYSIS_CACHE_MAX_SIZE (64 * 1024 * 1024)
+#endif
+
+bool TestAnalysisCacheKey::operator< (const TestAnalysisCacheKey& other) const noexcept
+{
+    return std::tie (_sampleHash, _sampleCount, _sampleRate, _channelCount, _algorithmIdentifier) <
+            std::tie (other._sampleHash, other._sampleCount, other._sampleRate, other._channelCount, other._algorithmIdentifier);
+}
+
+bool TestAnalysisCache::createKey (TestAnalysisCallbacks* analysisCallbacks, const int64_t sampleCount, const double sampleRate, const uint32_t channelCount,
+                                   const TestProcessingAlgorithm* processingAlgorithm, TestAnalysisCacheKey& key)
+{
+    key._algorithmIdentifier = processingAlgorithm->getIdentifier ();
+    key._sampleCount = sampleCount;
+    key._sampleRate = sampleRate;
+    key._channelCount = channelCount;
+
+    // FNV-1a hash of the raw sample data, processing the bits of each sample at once rather than byte by byte
+    uint64_t hash { 14695981039346656037ULL };
+    const auto blockSize { std::min (cacheKeyBlockSize, sampleCount) };
+    std::vector<float> buffer (channelCount * static_cast<size_t> (blockSize));
+    std::vector<void*> dataPointers (channelCount);
+    for (auto c { 0U }; c < channelCount; ++c)
+        dataPointers[c] = buffer.data () + c * static_cast<size_t> (blockSize);
+
+    for (int64_t blockStart { 0 }; blockStart < sampleCount; blockStart += blockSize)
+    {
+        if (analysisCallbacks->shouldCancel ())
+            return false;
+
+        const auto count { std::min (blockSize, sampleCount - blockStart) };
+        if (!analysisCallbacks->readAudioSamples (blockStart, count, dataPointers.data ()))
+            return false;
+
+        for (auto c { 0U }; c < channelCount; ++c)
+        {
+            const auto samples { static_cast<const float*> (dataPointers[c]) };
+            for (int64_t i { 0 }; i < count; ++i)
+            {
+                uint32_t sampleBits;
+                std::memcpy (&sampleBits, &samples[i], sizeof (sampleBits));
+                hash = (hash ^ sampleBits) * 1099511628211ULL;
+            }
+        }
+    }
+
+    key._sampleHash = hash;
+    return true;
+}
+
+// entry of the optional persistent cache, tracking its file size and last use for LRU eviction
+struct PersistentCacheEntry
+{
+    size_t _fileSize;
+    int64_t _lastUse;
+};
+
+struct CacheState
+{
+    CacheState ();
+    ~CacheState ();
+
+    std::mutex _mutex;
+
+    std::map<TestAnalysisCacheKey, TestNoteContent> _entries;
+    std::deque<TestAnalysisCacheKey> _insertionOrder;
+
+    // the bookkeeping of the persistent cache is guarded by _mutex too, but all file I/O is done without holding it
+    std::string _persistentDirectory;   // empty if persistent cache is disabled
+    size_t _persistentMaxSize { 0 };
+    std::map<std::string, PersistentCacheEntry> _persistentEntries;
+    std::set<std::pair<int64_t, std::string>> _persistentEntriesByLastUse;
+    size_t _persistentTotalSize { 0 };
+    int64_t _persistentUseCounter { 0 };
+    bool _isPersistentIndexDirty { false };     // the index is written lazily when storing entries
+
+    // serializes writing the index, so that an older state can never overwrite a newer one
+    std::mutex _persistentIndexWriteMutex;
+};
+
+static CacheState& getCacheState ()
+{
+    static CacheState cacheState;
+    return cacheState;
+}
+
+// must be called while holding the cache mutex
+static void addInMemoryEntry (CacheState& cacheState, const TestAnalysisCacheKey& key, const TestNoteContent& noteContent)
+{
+    // replace existing entries, e.g. after re-analyzing, but keep their position in the insertion order
+    const auto it { cacheState._entries.find (key) };
+    if (it != cacheState._entries.end ())
+    {
+        it->second = noteContent;
+        return;
+    }
+    cacheState._entries.emplace (key, noteContent);
+    cacheState._insertionOrder.emplace_back (key);
+
+    if (cacheState._insertionOrder.size () > cacheMaxEntryCount)
+    {
+        cacheState._entries.erase (cacheState._insertionOrder.front ());
+        cacheState._insertionOrder.pop_front ();
+    }
+}
+
+/*******************************************************************************/
+// Persistent cache files are stored using the TestArchiver format.
+// The directory contains an index file that tracks the size and last use of all entries,
+// and one file per entry which also stores the full key to detect file name collisions.
+// Note that access is only synchronized within the process, not across processes.
+// Since file I/O happens without holding the cache mutex, the index may briefly list a file that
+// is concurrently being removed - such entries are dropped when reading them fails.
+
+static const char* const persistentIndexFileName { "index.aracache" };
+
+static std::string getPersistentFilePath (const std::string& directory, const std::string& fileName)
+{
+    return directory + "/" + fileName;
+}
+
+static std::string getPersistentFileName (const TestAnalysisCacheKey& key)
+{
+    uint64_t hash { key._sampleHash };
+    const auto hashBytes { [&hash] (const void* data, size_t size)
+    {
+        for (auto i { 0U }; i < size; ++i)
+            hash = (hash ^ static_cast<const uint8_t*> (data)[i]) * 1099511628211ULL;
+    } };
+    hashBytes (&key._sampleCount, sizeof (key._sampleCount));
+    hashBytes (&key._sampleRate, sizeof (key._sampleRate));
+    hashBytes (&key._channelCount, sizeof (key._channelCount));
+    hashBytes (key._algorithmIdentifier.data (), key._algorithmIdentifier.size ());
+
+    std::ostringstream fileName;
+    fileName << std::hex << std::setw (16) << std::setfill ('0') << hash << ".aracache";
+    return fileName.str ();
+}
+
+// returns the file size, or 0 upon failure
+static size_t writePersistentFile (const std::string& filePath, const std::function<void (TestArchiver&)>& encodeFunction)
+{
+    std::vector<uint8_t> data;
+    TestArchiver archiver { [&data] (size_t position, size_t length, const uint8_t buffer[]) -> bool
+                            {
+                                if (data.size () < position + length)
+                                    data.resize (position + length);
+                                std::memcpy (data.data () + position, buffer, length);
+                                return true;
+                            } };
+    encodeFunction (archiver);
+    if (!archiver.didSucceed ())
+        return 0;
+
+    // write to a temporary file first and then replace the target, so that a failure while writing never leaves a truncated file
+    // (the temporary file name is unique so that concurrent writes of the same file do not interfere)
+    static std::atomic<uint32_t> tempFileCounter { 0 };
+    const auto tempFilePath { filePath + "." + std::to_string (++tempFileCounter) + ".tmp" };
+    {
+        std::ofstream file { tempFilePath, std::ios::binary | std::ios::trunc };
+        file.write (reinterpret_cast<const char*> (data.data ()), static_cast<std::streamsize> (data.size ()));
+        file.close ();
+        if (!file.good ())
+        {
+            std::remove (tempFilePath.c_str ());
+            return 0;
+        }
+    }
+
+    // on Windows, renaming fails if the target exists
+    if ((std::rename (tempFilePath.c_str (), filePath.c_str ()) != 0) &&
+        ((std::remove (filePath.c_str ()) != 0) || (std::rename (tempFilePath.c_str (), filePath.c_str ()) != 0)))
+    {
+        std::remove (tempFilePath.c_str ());
+        return 0;
+    }
+    return data.size ();
+}
+
+static bool readPersistentFile (const std::string& filePath, const std::function<void (TestUnarchiver&)>& decodeFunction)
+{
+    std::ifstream file { filePath, std::ios::binary };
+    if (!file)
+        return false;
+    const std::vector<uint8_t> data { std::istreambuf_iterator<char> { file }, std::istreambuf_iterator<char> {} };
+
+    TestUnarchiver unarchiver { [&data] (size_t position, size_t length, uint8_t buffer[]) -> bool
+                                {
+                                    if (data.size () < position + length)
+                                        return false;
+                                    std::memcpy (buffer, data.data () + position, length);
+                                    return true;
+                                } };
+    // corrupted data may still cause exceptions when decoding, e.g. due to allocation failures
+    try
+    {
+        decodeFunction (unarchiver);
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+    return unarchiver.didSucceed ();
+}
+
+static void removePersistentFiles (const std::vector<std::string>& filePaths)
+{
+    for (const auto& filePath : filePaths)
+        std::remove (filePath.c_str ());
+}
+
+static std::map<std::string, PersistentCacheEntry> readPersistentIndex (const std::string& directory)
+{
+    std::map<std::string, PersistentCacheEntry> persistentEntries;
+    if (!readPersistentFile (getPersistentFilePath (directory, persistentIndexFileName), [&persistentEntries] (TestUnarchiver& unarchiver)
+        {
+            const auto entryCount { unarchiver.readSize () };
+            for (auto i { 0U }; (i < entryCount) && unarchiver.didSucceed (); ++i)
+            {
+                auto fileName { unarchiver.readString () };
+                const auto fileSize { unarchiver.readSize () };
+                const auto lastUse { unarchiver.readInt64 () };
+                persistentEntries.emplace (std::move (fileName), PersistentCacheEntry { fileSize, lastUse });
+            }
+        }))
+        persistentEntries.clear ();
+    return persistentEntries;
+}
+
+// writes the index if it has changed - must be called without holding the cache mutex
+static void flushPersistentIndex (CacheState& cacheState)
+{
+    std::lock_guard<std::mutex> writeLock { cacheState._persistentIndexWriteMutex };
+
+    std::string directory;
+    std::map<std::string, PersistentCacheEntry> persistentEntries;
+    {
+        std::lock_guard<std::mutex> lock { cacheState._mutex };
+        if (!cacheState._isPersistentIndexDirty || cacheState._persistentDirectory.empty ())
+            return;
+        directory = cacheState._persistentDirectory;
+        persistentEntries = cacheState._persistentEntries;
+        cacheState._isPersistentIndexDirty = false;
+    }
+
+    writePersistentFile (getPersistentFilePath (directory, persistentIndexFileName), [&persistentEntries] (TestArchiver& archiver)
+    {
+        archiver.writeSize (persistentEntries.size ());
+        for (const auto& entry : persistentEntries)
+        {
+            archiver.writeString (entry.first);
+            archiver.writeSize (entry.second._fileSize);
+            archiver.writeInt64 (entry.second._lastUse);
+        }
+    });
+}
+
+// must be called while holding the cache mutex
+static void erasePersistentEntry (CacheState& cacheState, std::map<std::string, PersistentCacheEntry>::iterator entry)
+{
+    cacheState._persistentEntriesByLastUse.erase ({ entry->second._lastUse, entry->first });
+    cacheState._persistentTotalSize -= entry->second._fileSize;
+    cacheState._persistentEntries.erase (entry);
+    cacheState._isPersistentIndexDirty = true;
+}
+
+// must be called while holding the cache mutex
+static void setPersistentEntry (CacheState& cacheState, const std::string& fileName, const size_t fileSize, const int64_t lastUse)
+{
+    const auto existingEntry { cacheState._persistentEntries.find (fileName) };
+    if (existingEntry != cacheState._persistentEntries.end ())
+        erasePersistentEntry (cacheState, existingEntry);
+
+    cacheState._persistentEntries.emplace (fileName, PersistentCacheEntry { fileSize, lastUse });
+    cacheState._persistentEntriesByLastUse.emplace (lastUse, fileName);
+    cacheState._persistentTotalSize += fileSize;
+    cacheState._persistentUseCounter = std::max (cacheState._persistentUseCounter, lastUse);
+    cacheState._isPersistentIndexDirty = true;
+}
+
+// evicts least recently used entries until the size cap is met - must be called while holding the
+// cache mutex, returns the paths of the evicted files which must then be removed without holding it
+static std::vector<std::string> evictPersistentEntries (CacheState& cacheState)
+{
+    std::vector<std::string> filePaths;
+    while (cacheState._persistentTotalSize > cacheState._persistentMaxSize)
+    {
+        const auto& leastRecentlyUsed { *cacheState._persistentEntriesByLastUse.begin () };
+        filePaths.emplace_back (getPersistentFilePath (cacheState._persistentDirectory, leastRecentlyUsed.second));
+        erasePersistentEntry (cacheState, cacheState._persistentEntries.find (leastRecentlyUsed.second));
+    }
+    return filePaths;
+}
+
+// must be called while holding the cache mutex (or while constructing the state), returns the files to remove
+static std::vector<std::string> installPersistentDirectory (CacheState& cacheState, const std::string& directory, const size_t maxSizeInBytes,
+                                                            const std::map<std::string, PersistentCacheEntry>& persistentEntries)
+{
+    cacheState._persistentDirectory = directory;
+    cacheState._persistentMaxSize = maxSizeInBytes;
+    cacheState._persistentEntries.clear ();
+    cacheState._persistentEntriesByLastUse.clear ();
+    cacheState._persistentTotalSize = 0;
+    cacheState._persistentUseCounter = 0;
+    for (const auto& entry : persistentEntries)
+        setPersistentEntry (cacheState, entry.first, entry.second._fileSize, entry.second._lastUse);
+    cacheState._isPersistentIndexDirty = false;
+
+    return evictPersistentEntries (cacheState);
+}
+
+static void encodeCacheKey (const TestAnalysisCacheKey& key, TestArchiver& archiver)
+{
+    archiver.writeString (key._algorithmIdentifier);
+    archiver.writeInt64 (key._sampleCount);
+    archiver.writeDouble (key._sampleRate);
+    archiver.writeInt64 (key._channelCount);
+    archiver.writeInt64 (static_cast<int64_t> (key._sampleHash));
+}
+
+static TestAnalysisCacheKey decodeCacheKey (TestUnarchiver& unarchiver)
+{
+    TestAnalysisCacheKey key;
+    key._algorithmIdentifier = unarchiver.readString ();
+    key._sampleCount = unarchiver.readInt64 ();
+    key._sampleRate = unarchiver.readDouble ();
+    key._channelCount = static_cast<uint32_t> (unarchiver.readInt64 ());
+    key._sampleHash = static_cast<uint64_t> (unarchiver.readInt64 ());
+    return key;
+}
+
+CacheState::CacheState ()
+{
+    // the persistent cache can be enabled without recompiling by setting this environment variable to an existing directory
+    const auto directory { getEnvironmentVariable ("ARA_TEST_ANALYSIS_CACHE_DIRECTORY") };
+    if (!directory.empty ())
+        removePersistentFiles (installPersistentDirectory (*this, directory, ARA_PERSISTENT_ANALYSIS_CACHE_MAX_SIZE, readPersistentIndex (directory)));
+}
+
+CacheState::~CacheState ()
+{
+    flushPersistentIndex (*this);
+}
+
+/*******************************************************************************/
+
+void TestAnalysisCache::setPersistentDirectory (const std::string& directory, size_t maxSizeInBytes)
+{
+    auto& cacheState { getCacheState () };
+    flushPersistentIndex (cacheState);
+
+    const auto persistentEntries { (directory.empty ()) ? std::map<std::string, PersistentCacheEntry> {} : readPersistentIndex (directory) };
+
+    std::vector<std::string> evictedFilePaths;
+    {
+        std::lock_guard<std::mutex> lock { cacheState._mutex };
+        evictedFilePaths = installPersistentDirectory (cacheState, directory, maxSizeInBytes, persistentEntries);
+    }
+    removePersistentFiles (evictedFilePaths);
+    flushPersistentIndex (cacheState);
+}
+
+std::unique_ptr<TestNoteContent> TestAnalysisCache::getNoteContent (const TestAnalysisCacheKey& key)
+{
+    auto& cacheState { getCacheState () };
+
+    std::string directory;
+    const auto fileName { getPersistentFileName (key) };
+    {
+        std::lock_guard<std::mutex> lock { cacheState._mutex };
+
+        const auto it { cacheState._entries.find (key) };
+        if (it != cacheState._entries.end ())
+            return std::make_unique<TestNoteContent> (it->second);
+
+        if (cacheState._persistentDirectory.empty () || (cacheState._persistentEntries.count (fileName) == 0))
+            return nullptr;
+        directory = cacheState._persistentDirectory;
+    }
+
+    const auto filePath { getPersistentFilePath (directory, fileName) };
+    std::unique_ptr<TestNoteContent> noteContent;
+    const bool didRead { readPersistentFile (filePath, [&key, &noteContent] (TestUnarchiver& unarchiver)
+        {
+            const auto persistentKey { decodeCacheKey (unarchiver) };
+            if (!(persistentKey < key) && !(key < persistentKey))
+                noteContent = decodeTestNoteContent (unarchiver);
+        }) };
+    if (!didRead)
+        noteContent.reset ();
+
+    {
+        std::lock_guard<std::mutex> lock { cacheState._mutex };
+
+        // the entry may have been changed while reading
+        const auto persistentEntry { cacheState._persistentEntries.find (fileName) };
+        if ((directory != cacheState._persistentDirectory) || (persistentEntry == cacheState._persistentEntries.end ()))
+            return noteContent;
+
+        if (noteContent)
+        {
+            const auto fileSize { persistentEntry->second._fileSize };
+            setPersistentEntry (cacheState, fileName, fileSize, cacheState._persistentUseCounter + 1);
+            addInMemoryEntry (cacheState, key, *noteContent);
+            return noteContent;
+        }
+
+        // drop outdated or corrupted entries (or, very unlikely, file name collisions)
+        erasePersistentEntry (cacheState, persistentEntry);
+    }
+    std::remove (filePath.c_str ());
+    return nullptr;
+}
+
+bool TestAnalysisCache::hasNoteContent (const TestAnalysisCacheKey& key)
+{
+    auto& cacheState { getCacheState () };
+    std::lock_guard<std::mutex> lock { cacheState._mutex };
+
+    if (cacheState._entries.count (key) != 0)
+        return true;
+
+    // the persistent entry may turn out to be outdated or corrupted when reading it, or (very unlikely)
+    // belong to a different key with colliding file name - this is acceptable for merely skipping work
+    return !cacheState._persistentDirectory.empty () && (cacheState._persistentEntries.count (getPersistentFileName (key)) != 0);
+}
+
+void TestAnalysisCache::storeNoteContent (const TestAnalysisCacheKey& key, const TestNoteContent& noteContent)
+{
+    auto& cacheState { getCacheState () };
+
+    std::string directory;
+    {
+        std::lock_guard<std::mutex> lock { cacheState._mutex };
+        addInMemoryEntry (cacheState, key, noteContent);
+        directory = cacheState._persistentDirectory;
+    }
+    if (directory.empty ())
+        return;
+
+    const auto fileName { getPersistentFileName (key) };
+    const auto fileSize { writePersistentFile (getPersistentFilePath (directory, fileName), [&key, &noteContent] (TestArchiver& archiver)
+        {
+            encodeCacheKey (key, archiver);
+            encodeTestNoteContent (&noteContent, archiver);
+        }) };
+
+    std::vector<std::string> evictedFilePaths;
+    {
+        std::lock_guard<std::mutex> lock { cacheState._mutex };
+        if (directory != cacheState._persistentDirectory)
+            return;
+
+        if (fileSize != 0)
+        {
+            setPersistentEntry (cacheState, fileName, fileSize, cacheState._persistentUseCounter + 1);
+            evictedFilePaths = evictPersistentEntries (cacheState);
+        }
+        else
+        {
+            const auto persistentEntry { cacheState._persistentEntries.find (fileName) };
+            if (persistentEntry != cacheState._persistentEntries.end ())
+                erasePersistentEntry (cacheState, persistentEntry);
+        }
+    }
+    removePersistentFiles (evictedFilePaths);
+    flushPersistentIndex (cacheState);
+}
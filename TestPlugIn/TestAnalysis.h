@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstdint>
 
 class TestArchiver;
 class TestUnarchiver;
@@ -52,6 +53,35 @@ public:
     virtual bool shouldCancel () const noexcept { return false; }
 };
 
+/*******************************************************************************/
+// Runtime control of the artificial delays that the test algorithms use to simulate expensive analysis.
+// The initial mode is realTimeScaled with ARA_FAKE_NOTE_ANALYSIS_SPEED_FACTOR (see TestAnalysis.cpp),
+// or unthrottled if that factor is 0. It can be overridden via the environment variable
+// ARA_TEST_ANALYSIS_PACING, set to "unthrottled", "realtime[:<speedFactor>]" or "virtual[:<speedFactor>]".
+// In virtualClock mode, analysis time is measured on a virtual clock that advances by
+// virtualClockTickDuration each time the host calls notifyModelUpdates (), which makes the number
+// of host update cycles needed to complete an analysis independent of the machine it runs on.
+// Note that hosts must keep polling for model updates in this mode for analyses to complete.
+// The settings are global and apply to all analyses started after the change.
+class TestAnalysisPacing
+{
+public:
+    enum class Mode
+    {
+        unthrottled,
+        realTimeScaled,
+        virtualClock
+    };
+
+    static constexpr double virtualClockTickDuration { 0.05 };
+
+    // analysis takes the duration of the analyzed audio divided by speedFactor (ignored when unthrottled)
+    static void configure (Mode mode, double speedFactor);
+    static Mode getMode ();
+
+    static void advanceVirtualClock ();
+};
+
 /*******************************************************************************/
 class TestProcessingAlgorithm
 {
@@ -73,7 +103,61 @@ public:
 
     virtual std::unique_ptr<TestNoteContent> analyzeNoteContent (TestAnalysisCallbacks* analysisCallbacks, int64_t sampleCount, double sampleRate, uint32_t channelCount) const = 0;
 
+    // re-analyze after the samples in [startSample, endSample) have changed, updating the previous analysis result
+    // upon return, the sample range is set to the range that actually has been re-analyzed
+    // by default, the entire audio source is analyzed again
+    virtual std::unique_ptr<TestNoteContent> reanalyzeNoteContent (TestAnalysisCallbacks* analysisCallbacks, int64_t sampleCount, double sampleRate, uint32_t channelCount,
+                                                                   const TestNoteContent& previousContent, int64_t& startSample, int64_t& endSample) const;
+
+    // analyze with several algorithms in a single pass: the algorithms run concurrently, and each block
+    // of samples is read only once and then shared between all of them
+    // returns the results in the order of the algorithms - results of cancelled analyses are nullptr
+    static std::vector<std::unique_ptr<TestNoteContent>> analyzeNoteContentWithAlgorithms (const std::vector<const TestProcessingAlgorithm*>& algorithms,
+                                                                                            TestAnalysisCallbacks* analysisCallbacks, int64_t sampleCount, double sampleRate, uint32_t channelCount);
+
+    // the algorithms that should be analyzed together in a single pass whenever analyzing with one of them,
+    // as configured at runtime via the environment variable ARA_TEST_ANALYSIS_SINGLE_PASS_ALGORITHMS
+    // (a comma-separated list of algorithm identifiers) - returns an empty list if this is not configured
+    static std::vector<const TestProcessingAlgorithm*> getSinglePassAlgorithms ();
+
 private:
     const char* _name;
     const char* _identifier;
 };
+
+/*******************************************************************************/
+// Process-wide cache of analysis results, shared across all documents.
+// Hosts may add the same audio multiple times, e.g. when restoring documents or re-importing files,
+// so the results are keyed by a fingerprint of the audio signal plus the algorithm identifier.
+struct TestAnalysisCacheKey
+{
+    bool operator< (const TestAnalysisCacheKey& other) const noexcept;
+
+    std::string _algorithmIdentifier;
+    int64_t _sampleCount;
+    double _sampleRate;
+    uint32_t _channelCount;
+    uint64_t _sampleHash;
+};
+
+class TestAnalysisCache
+{
+public:
+    // creates the fingerprint by hashing the entire audio signal - sampling only parts of it would
+    // return stale results for edits that happen to be outside of the sampled sections
+    // since this reads all samples, it should be called on the analysis thread rather than the main thread
+    // returns false if reading the samples failed or the analysis was cancelled, in which case the result must not be cached
+    static bool createKey (TestAnalysisCallbacks* analysisCallbacks, int64_t sampleCount, double sampleRate, uint32_t channelCount,
+                           const TestProcessingAlgorithm* processingAlgorithm, TestAnalysisCacheKey& key);
+
+    // returns a copy of the cached analysis result, or nullptr if there is none
+    static std::unique_ptr<TestNoteContent> getNoteContent (const TestAnalysisCacheKey& key);
+    // returns true if there is a cached analysis result, without reading it or counting it as use
+    static bool hasNoteContent (const TestAnalysisCacheKey& key);
+    static void storeNoteContent (const TestAnalysisCacheKey& key, const TestNoteContent& noteContent);
+
+    // optionally, results can also be persisted to an existing local directory, so that they survive restarting the process
+    // the files in the directory are evicted least-recently-used first when exceeding the given size - pass an empty string to disable
+    // the initial directory can be set via the environment variable ARA_TEST_ANALYSIS_CACHE_DIRECTORY
+    static void setPersistentDirectory (const std::string& directory, size_t maxSizeInBytes);
+};
@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------------
+//! \file       TestFFT.cpp
+//!             minimal real-valued FFT for the ARA test plug-in analysis
+//! \project    ARA SDK Examples
+//! \copyright  Copyright (c) 2018-2025, Celemony Software GmbH, All Rights Reserved.
+//! \license    Licensed under the Apache License, Version 2.0 (the "License");
+//!             you may not use this file except in compliance with the License.
+//!             You may obtain a copy of the License at
+//!
+//!               http://www.apache.org/licenses/LICENSE-2.0
+//!
+//!             Unless required by applicable law or agreed to in writing, software
+//!             distributed under the License is distributed on an "AS IS" BASIS,
+//!             WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//!             See the License for the specific language governing permissions and
+//!             limitations under the License.
+//------------------------------------------------------------------------------
+
+#include "TestFFT.h"
+
+#include "ARA_Library/Debug/ARADebug.h"
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+
+/*******************************************************************************/
+
+TestFFT::TestFFT (size_t size)
+: _size { size }
+{
+    ARA_INTERNAL_ASSERT ((size >= 4) && ((size & (size - 1)) == 0));
+
+    const auto pi { 3.14159265358979323846 };
+    const auto halfSize { size / 2 };
+
+    size_t bitCount { 0 };
+    while ((static_cast<size_t> (1) << bitCount) < halfSize)
+        ++bitCount;
+    _bitReversedIndices.resize (halfSize);
+    for (size_t i { 0 }; i < halfSize; ++i)
+    {
+        size_t reversed { 0 };
+        for (size_t bit { 0 }; bit < bitCount; ++bit)
+            reversed |= ((i >> bit) & 1) << (bitCount - 1 - bit);
+        _bitReversedIndices[i] = reversed;
+    }
+
+    _complexTwiddles.reserve (halfSize / 2);
+    for (size_t k { 0 }; k < halfSize / 2; ++k)
+        _complexTwiddles.emplace_back (std::polar (1.0, -2.0 * pi * static_cast<double> (k) / static_cast<double> (halfSize)));
+
+    _realTwiddles.reserve (halfSize);
+    for (size_t k { 0 }; k < halfSize; ++k)
+        _realTwiddles.emplace_back (std::polar (1.0, -2.0 * pi * static_cast<double> (k) / static_cast<double> (size)));
+
+    _hannWindow.reserve (size);
+    for (size_t i { 0 }; i < size; ++i)
+    {
+        _hannWindow.push_back (static_cast<float> (0.5 - 0.5 * std::cos (2.0 * pi * static_cast<double> (i) / static_cast<double> (size))));
+        _hannWindowSum += _hannWindow.back ();
+    }
+}
+
+const TestFFT& TestFFT::getSharedPlan (size_t size)
+{
+    static std::mutex plansMutex;
+    static std::map<size_t, std::unique_ptr<const TestFFT>> plans;
+
+    std::lock_guard<std::mutex> lock { plansMutex };
+    auto& plan { plans[size] };
+    if (!plan)
+        plan.reset (new TestFFT { size });
+    return *plan;
+}
+
+void TestFFT::perform (const float input[], Complex output[], Scratch& scratch) const
+{
+    const auto halfSize { _size / 2 };
+
+    // pack even samples into the real and odd samples into the imaginary part, in bit reversed order
+    auto& buffer { scratch._buffer };
+    buffer.resize (halfSize);
+    for (size_t i { 0 }; i < halfSize; ++i)
+    {
+        const auto sourceIndex { 2 * _bitReversedIndices[i] };
+        buffer[i] = Complex { input[sourceIndex], input[sourceIndex + 1] };
+    }
+
+    // iterative radix-2 decimation-in-time butterflies
+    for (size_t length { 2 }; length <= halfSize; length *= 2)
+    {
+        const auto halfLength { length / 2 };
+        const auto twiddleStride { halfSize / length };
+        for (size_t start { 0 }; start < halfSize; start += length)
+        {
+            for (size_t j { 0 }; j < halfLength; ++j)
+            {
+                const auto even { buffer[start + j] };
+                const auto odd { buffer[start + j + halfLength] * _complexTwiddles[j * twiddleStride] };
+                buffer[start + j] = even + odd;
+                buffer[start + j + halfLength] = even - odd;
+            }
+        }
+    }
+
+    // split the packed result into the spectra of even and odd samples and combine them
+    output[0] = Complex { buffer[0].real () + buffer[0].imag (), 0.0f };
+    output[halfSize] = Complex { buffer[0].real () - buffer[0].imag (), 0.0f };
+    for (size_t k { 1 }; k < halfSize; ++k)
+    {
+        const auto z { buffer[k] };
+        const auto zMirrored { std::conj (buffer[halfSize - k]) };
+        const auto evenSpectrum { 0.5f * (z + zMirrored) };
+        const auto oddSpectrum { Complex { 0.0f, -0.5f } * (z - zMirrored) };
+        output[k] = evenSpectrum + _realTwiddles[k] * oddSpectrum;
+    }
+}
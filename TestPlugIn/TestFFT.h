@@ -0,0 +1,66 @@
+//------------------------------------------------------------------------------
+//! \file       TestFFT.h
+//!             minimal real-valued FFT for the ARA test plug-in analysis
+//! \project    ARA SDK Examples
+//! \copyright  Copyright (c) 2018-2025, Celemony Software GmbH, All Rights Reserved.
+//! \license    Licensed under the Apache License, Version 2.0 (the "License");
+//!             you may not use this file except in compliance with the License.
+//!             You may obtain a copy of the License at
+//!
+//!               http://www.apache.org/licenses/LICENSE-2.0
+//!
+//!             Unless required by applicable law or agreed to in writing, software
+//!             distributed under the License is distributed on an "AS IS" BASIS,
+//!             WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//!             See the License for the specific language governing permissions and
+//!             limitations under the License.
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+// Radix-2 FFT for real input signals, implemented as complex FFT of half the size
+// followed by a split step that separates the spectra of even and odd samples.
+// A TestFFT object is a "plan": all tables are calculated once upon construction and
+// are immutable afterwards, so plans can be shared between concurrent analysis threads.
+// All temporary data is kept in the Scratch buffers provided by the caller, which
+// should be reused across calls (typically one per thread) to avoid allocations.
+// Actual plug-ins will rather use an optimized FFT library such as those provided by the OS.
+class TestFFT
+{
+public:
+    using Complex = std::complex<float>;
+
+    // reusable temporary buffers for perform ()
+    struct Scratch
+    {
+        std::vector<Complex> _buffer;
+    };
+
+    // size must be a power of 2, at least 4
+    explicit TestFFT (size_t size);
+
+    // returns a plan for the given size, creating it upon first request - thread-safe,
+    // the returned plan remains valid until the program terminates
+    static const TestFFT& getSharedPlan (size_t size);
+
+    size_t getSize () const noexcept { return _size; }
+
+    // periodic Hann window of getSize () samples, and its sum (needed to normalize magnitudes)
+    const std::vector<float>& getHannWindow () const noexcept { return _hannWindow; }
+    float getHannWindowSum () const noexcept { return _hannWindowSum; }
+
+    // transforms getSize () real samples into getSize () / 2 + 1 complex bins (DC up to Nyquist)
+    void perform (const float input[], Complex output[], Scratch& scratch) const;
+
+private:
+    const size_t _size;
+    std::vector<size_t> _bitReversedIndices;    // permutation for the half-size complex FFT
+    std::vector<Complex> _complexTwiddles;      // exp (-2 pi i k / (size / 2)) for k < size / 4
+    std::vector<Complex> _realTwiddles;         // exp (-2 pi i k / size) for k < size / 2
+    std::vector<float> _hannWindow;
+    float _hannWindowSum { 0.0f };
+};
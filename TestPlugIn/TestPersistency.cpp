@@ -158,6 +158,14 @@ std::string TestUnarchiver::readString ()
     const size_t numBytes { readSize () };
     if (didSucceed () && numBytes)
     {
+        // validate the size before allocating, since it may be corrupted: the last byte of the string must be readable
+        uint8_t lastByte;
+        if ((numBytes >= std::numeric_limits<size_t>::max () - _location) || !_readFunction (_location + numBytes - 1, 1, &lastByte))
+        {
+            _state = TestArchiveState::iOError;
+            return data;
+        }
+
         std::vector<char> stringBuffer (numBytes + 1);
         if (_readFunction (_location, numBytes, reinterpret_cast<uint8_t*> (stringBuffer.data ())))
             data = stringBuffer.data ();
@@ -0,0 +1,228 @@
+//------------------------------------------------------------------------------
+//! \file       TestRenderWorkerPool.cpp
+//!             worker thread pool to distribute rendering in the ARA test plug-in
+//! \project    ARA SDK Examples
+//! \copyright  Copyright (c) 2018-2025, Celemony Software GmbH, All Rights Reserved.
+//! \license    Licensed under the Apache License, Version 2.0 (the "License");
+//!             you may not use this file except in compliance with the License.
+//!             You may obtain a copy of the License at
+//!
+//!               http://www.apache.org/licenses/LICENSE-2.0
+//!
+//!             Unless required by applicable law or agreed to in writing, software
+//!             distributed under the License is distributed on an "AS IS" BASIS,
+//!             WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//!             See the License for the specific language governing permissions and
+//!             limitations under the License.
+//------------------------------------------------------------------------------
+
+#include "TestRenderWorkerPool.h"
+
+#include "ARA_Library/Debug/ARADebug.h"
+
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <map>
+#include <mutex>
+
+#if defined (_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <Windows.h>
+#endif
+
+// idle workers spin this long for the next job before going to sleep
+static constexpr std::chrono::microseconds spinDuration { 500 };
+
+/*******************************************************************************/
+
+#if defined (_WIN32)
+
+TestRenderWorkerPool::WakeupSemaphore::WakeupSemaphore ()
+: _handle { ::CreateSemaphore (nullptr, 0, LONG_MAX, nullptr) }
+{
+    ARA_INTERNAL_ASSERT (_handle != nullptr);
+}
+
+TestRenderWorkerPool::WakeupSemaphore::~WakeupSemaphore ()
+{
+    ::CloseHandle (_handle);
+}
+
+void TestRenderWorkerPool::WakeupSemaphore::signal (int count) noexcept
+{
+    ::ReleaseSemaphore (_handle, count, nullptr);
+}
+
+void TestRenderWorkerPool::WakeupSemaphore::wait () noexcept
+{
+    ::WaitForSingleObject (_handle, INFINITE);
+}
+
+#elif defined (__APPLE__)
+
+TestRenderWorkerPool::WakeupSemaphore::WakeupSemaphore ()
+: _semaphore { dispatch_semaphore_create (0) }
+{
+    ARA_INTERNAL_ASSERT (_semaphore != nullptr);
+}
+
+TestRenderWorkerPool::WakeupSemaphore::~WakeupSemaphore ()
+{
+    dispatch_release (_semaphore);
+}
+
+void TestRenderWorkerPool::WakeupSemaphore::signal (int count) noexcept
+{
+    for (auto i { 0 }; i < count; ++i)
+        dispatch_semaphore_signal (_semaphore);
+}
+
+void TestRenderWorkerPool::WakeupSemaphore::wait () noexcept
+{
+    dispatch_semaphore_wait (_semaphore, DISPATCH_TIME_FOREVER);
+}
+
+#else
+
+TestRenderWorkerPool::WakeupSemaphore::WakeupSemaphore ()
+{
+    int ARA_MAYBE_UNUSED_VAR (result);
+    result = sem_init (&_semaphore, 0, 0);
+    ARA_INTERNAL_ASSERT (result == 0);
+}
+
+TestRenderWorkerPool::WakeupSemaphore::~WakeupSemaphore ()
+{
+    sem_destroy (&_semaphore);
+}
+
+void TestRenderWorkerPool::WakeupSemaphore::signal (int count) noexcept
+{
+    for (auto i { 0 }; i < count; ++i)
+        sem_post (&_semaphore);
+}
+
+void TestRenderWorkerPool::WakeupSemaphore::wait () noexcept
+{
+    while ((sem_wait (&_semaphore) != 0) && (errno == EINTR))
+    {}
+}
+
+#endif
+
+/*******************************************************************************/
+
+TestRenderWorkerPool::TestRenderWorkerPool (int workerThreadCount)
+{
+    ARA_INTERNAL_ASSERT (workerThreadCount >= 0);
+
+    _workerThreads.reserve (static_cast<size_t> (workerThreadCount));
+    for (auto i { 1 }; i <= workerThreadCount; ++i)
+        _workerThreads.emplace_back ([this, i] () { runWorkerThread (i); });
+}
+
+TestRenderWorkerPool::~TestRenderWorkerPool ()
+{
+    ARA_INTERNAL_ASSERT (!_isInUse);
+
+    _shouldStop = true;
+    _wakeupSemaphore.signal (getWorkerThreadCount ());
+    for (auto& workerThread : _workerThreads)
+        workerThread.join ();
+}
+
+std::shared_ptr<TestRenderWorkerPool> TestRenderWorkerPool::getSharedPool (int workerThreadCount)
+{
+    static std::mutex poolsMutex;
+    static std::map<int, std::weak_ptr<TestRenderWorkerPool>> pools;
+
+    std::lock_guard<std::mutex> lock { poolsMutex };
+    auto& weakPool { pools[workerThreadCount] };
+    auto pool { weakPool.lock () };
+    if (!pool)
+    {
+        pool = std::make_shared<TestRenderWorkerPool> (workerThreadCount);
+        weakPool = pool;
+    }
+    return pool;
+}
+
+/*******************************************************************************/
+
+bool TestRenderWorkerPool::perform (Job& job, size_t itemCount) noexcept
+{
+    auto isInUse { false };
+    if (!_isInUse.compare_exchange_strong (isInUse, true, std::memory_order_acquire))
+        return false;
+
+    // publish the job - the sequentially consistent store to _isJobActive makes it visible to any
+    // worker that subsequently registers as busy and then finds the job active
+    _job = &job;
+    _itemCount = itemCount;
+    _nextItemIndex.store (0, std::memory_order_relaxed);
+    _isJobActive = true;
+    ++_jobGeneration;
+    if (const auto sleepingWorkerCount { _sleepingWorkerCount.load () })
+        _wakeupSemaphore.signal (sleepingWorkerCount);
+
+    processItems (0);
+
+    // once deactivated, no further worker will touch the job - wait for those still processing an item
+    // (either a worker registered as busy before this point and will be waited for, or it will see the
+    // deactivation, since both sides store first and then load sequentially consistent)
+    _isJobActive = false;
+    while (_busyWorkerCount > 0)
+        std::this_thread::yield ();
+
+    _job = nullptr;
+    _isInUse.store (false, std::memory_order_release);
+    return true;
+}
+
+void TestRenderWorkerPool::processItems (int workerIndex) noexcept
+{
+    for (auto itemIndex { _nextItemIndex.fetch_add (1, std::memory_order_relaxed) }; itemIndex < _itemCount;
+         itemIndex = _nextItemIndex.fetch_add (1, std::memory_order_relaxed))
+        _job->processItem (itemIndex, workerIndex);
+}
+
+void TestRenderWorkerPool::runWorkerThread (int workerIndex) noexcept
+{
+    auto lastJobGeneration { _jobGeneration.load () };
+    while (waitForNextJob (lastJobGeneration))
+    {
+        lastJobGeneration = _jobGeneration.load ();
+
+        ++_busyWorkerCount;
+        if (_isJobActive)
+            processItems (workerIndex);
+        --_busyWorkerCount;
+    }
+}
+
+bool TestRenderWorkerPool::waitForNextJob (unsigned int lastJobGeneration) noexcept
+{
+    const auto hasNextJob { [this, lastJobGeneration] () { return _shouldStop || (_jobGeneration != lastJobGeneration); } };
+
+    const auto spinEnd { std::chrono::steady_clock::now () + spinDuration };
+    while (!hasNextJob ())
+    {
+        if (std::chrono::steady_clock::now () < spinEnd)
+        {
+            std::this_thread::yield ();
+            continue;
+        }
+
+        // the render thread checks _sleepingWorkerCount after advancing _jobGeneration, and both
+        // sides store first and then load sequentially consistent - so either this sees the new
+        // generation, or the render thread sees this worker and signals the semaphore, which is not
+        // lost even if it happens before waiting. Workers that are counted but do not wait (or are
+        // counted again before decrementing) cause spurious wakeups, which the loop tolerates.
+        ++_sleepingWorkerCount;
+        if (!hasNextJob ())
+            _wakeupSemaphore.wait ();
+        --_sleepingWorkerCount;
+    }
+    return !_shouldStop;
+}
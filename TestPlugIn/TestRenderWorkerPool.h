@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+//! \file       TestRenderWorkerPool.h
+//!             worker thread pool to distribute rendering in the ARA test plug-in
+//! \project    ARA SDK Examples
+//! \copyright  Copyright (c) 2018-2025, Celemony Software GmbH, All Rights Reserved.
+//! \license    Licensed under the Apache License, Version 2.0 (the "License");
+//!             you may not use this file except in compliance with the License.
+//!             You may obtain a copy of the License at
+//!
+//!               http://www.apache.org/licenses/LICENSE-2.0
+//!
+//!             Unless required by applicable law or agreed to in writing, software
+//!             distributed under the License is distributed on an "AS IS" BASIS,
+//!             WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//!             See the License for the specific language governing permissions and
+//!             limitations under the License.
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#if defined (__APPLE__)
+    #include <dispatch/dispatch.h>
+#elif !defined (_WIN32)
+    #include <semaphore.h>
+#endif
+
+// Distributes a number of independent work items (e.g. playback regions) among the calling render
+// thread and a set of worker threads that are started upon construction.
+// The render thread never blocks on a lock or allocates memory when performing a job: it publishes
+// the job through atomics and processes items itself until none are left, so that the job completes
+// even if no worker thread picks it up in time. It then only waits for items that are currently
+// being processed by worker threads.
+// Idle workers briefly spin for the next job, since render calls follow each other quickly, and then
+// go to sleep on a counting semaphore until the render thread signals the next job, so that they do
+// not consume any CPU while rendering is paused or stopped.
+// Only one job can be performed at a time, concurrent calls from other render threads are rejected
+// so that they can fall back to serial processing.
+// Actual plug-ins will typically integrate with the host's thread pool where available, and use
+// platform-specific realtime thread priorities and workgroups for their worker threads.
+class TestRenderWorkerPool
+{
+public:
+    // a job processes items by index, calls for different items may happen concurrently
+    class Job
+    {
+    public:
+        virtual ~Job () = default;
+        // workerIndex is 0 for the calling thread, and 1..getWorkerThreadCount () for the worker
+        // threads - it can be used to access per-worker scratch buffers.
+        virtual void processItem (size_t itemIndex, int workerIndex) noexcept = 0;
+    };
+
+    explicit TestRenderWorkerPool (int workerThreadCount);
+    ~TestRenderWorkerPool ();
+
+    // returns a pool with the given worker thread count, creating it if it does not exist yet.
+    // the pool is shared by all callers and destroyed when the last reference is released -
+    // thread-safe, but may block and allocate, so it must not be called on the render thread.
+    static std::shared_ptr<TestRenderWorkerPool> getSharedPool (int workerThreadCount);
+
+    int getWorkerThreadCount () const noexcept { return static_cast<int> (_workerThreads.size ()); }
+
+    // number of distinct workerIndex values passed to Job::processItem ()
+    int getWorkerCount () const noexcept { return getWorkerThreadCount () + 1; }
+
+    // processes all items of the job before returning, using the calling thread as worker 0.
+    // realtime-safe, returns false without processing any item if the pool is already in use.
+    bool perform (Job& job, size_t itemCount) noexcept;
+
+private:
+    // Counting semaphore to wake up sleeping workers. Other than a condition variable, signaling it
+    // does not require a lock, and a signal is not lost if the worker did not start waiting yet.
+    // std::counting_semaphore would require C++20, so this uses the platform implementations,
+    // which do not block when signaling and thus can be used on the render thread.
+    class WakeupSemaphore
+    {
+    public:
+        WakeupSemaphore ();
+        ~WakeupSemaphore ();
+
+        void signal (int count) noexcept;
+        void wait () noexcept;
+
+    private:
+#if defined (_WIN32)
+        void* _handle;
+#elif defined (__APPLE__)
+        dispatch_semaphore_t _semaphore;
+#else
+        sem_t _semaphore;
+#endif
+    };
+
+    void runWorkerThread (int workerIndex) noexcept;
+    bool waitForNextJob (unsigned int lastJobGeneration) noexcept;
+    void processItems (int workerIndex) noexcept;
+
+private:
+    std::vector<std::thread> _workerThreads;
+
+    // guarded by _isInUse, published to the workers by setting _isJobActive
+    Job* _job { nullptr };
+    size_t _itemCount { 0 };
+
+    std::atomic<bool> _isInUse { false };
+    std::atomic<bool> _isJobActive { false };
+    std::atomic<unsigned int> _jobGeneration { 0 };
+    std::atomic<size_t> _nextItemIndex { 0 };
+    std::atomic<int> _busyWorkerCount { 0 };
+
+    // only used to let idle workers sleep
+    WakeupSemaphore _wakeupSemaphore;
+    std::atomic<int> _sleepingWorkerCount { 0 };
+    std::atomic<bool> _shouldStop { false };
+};
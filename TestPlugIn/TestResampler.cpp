@@ -0,0 +1,220 @@
+//------------------------------------------------------------------------------
+//! \file       TestResampler.cpp
+//!             polyphase windowed-sinc sample rate converter for the ARA test plug-in renderer
+//! \project    ARA SDK Examples
+//! \copyright  Copyright (c) 2018-2025, Celemony Software GmbH, All Rights Reserved.
+//! \license    Licensed under the Apache License, Version 2.0 (the "License");
+//!             you may not use this file except in compliance with the License.
+//!             You may obtain a copy of the License at
+//!
+//!               http://www.apache.org/licenses/LICENSE-2.0
+//!
+//!             Unless required by applicable law or agreed to in writing, software
+//!             distributed under the License is distributed on an "AS IS" BASIS,
+//!             WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//!             See the License for the specific language governing permissions and
+//!             limitations under the License.
+//------------------------------------------------------------------------------
+
+#include "TestResampler.h"
+
+#include "ARA_Library/Debug/ARADebug.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+// SIMD instruction sets used to optimize the filter kernel
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define ARA_TEST_RESAMPLER_USE_SSE2 1
+    #include <emmintrin.h>
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__) || defined (_M_ARM64)
+    #define ARA_TEST_RESAMPLER_USE_NEON 1
+    #include <arm_neon.h>
+#endif
+
+/*******************************************************************************/
+
+// stop band attenuation of the kernel in dB, and the matching Kaiser window shape parameter
+static constexpr double stopBandAttenuation { 90.0 };
+static constexpr double kaiserBeta { 0.1102 * (stopBandAttenuation - 8.7) };
+
+// zeroth order modified Bessel function of the first kind, needed for the Kaiser window
+static double besselI0 (double x)
+{
+    double result { 1.0 };
+    double term { 1.0 };
+    const auto halfX { x / 2.0 };
+    for (auto k { 1 }; term > 1.0e-12 * result; ++k)
+    {
+        term *= (halfX / k) * (halfX / k);
+        result += term;
+    }
+    return result;
+}
+
+TestResampler::TestResampler (double sourceSampleRate, double targetSampleRate, int kernelHalfWidth)
+: _sourceSampleRate { sourceSampleRate },
+  _targetSampleRate { targetSampleRate },
+  _kernelHalfWidth { kernelHalfWidth }
+{
+    ARA_INTERNAL_ASSERT ((sourceSampleRate > 0.0) && (targetSampleRate > 0.0));
+    ARA_INTERNAL_ASSERT (kernelHalfWidth >= 2);
+
+    const auto pi { 3.14159265358979323846 };
+
+    // when converting to a lower rate, the kernel is stretched so that it cuts off at the target Nyquist frequency
+    const auto bandwidthScale { std::min (1.0, targetSampleRate / sourceSampleRate) };
+
+    // the tap count is rounded up to a multiple of 4 so that the SIMD loops need no scalar remainder
+    auto halfTapCount { static_cast<int> (std::ceil (kernelHalfWidth / bandwidthScale)) };
+    halfTapCount += halfTapCount % 2;
+    _tapCount = 2 * halfTapCount;
+
+    // place the cutoff so that the transition band of the windowed sinc (which depends on its length)
+    // ends at the Nyquist frequency, with cutoff and transition width relative to the source Nyquist frequency
+    // (Kaiser's estimate for the filter length: tapCount = (attenuation - 8) / (2.285 * transition width in radians))
+    const auto transitionWidth { (stopBandAttenuation - 8.0) / (2.285 * 2.0 * kernelHalfWidth * pi) };
+    const auto cutoff { bandwidthScale * std::max (0.5, 1.0 - transitionWidth / 2.0) };
+
+    const auto windowNormalization { besselI0 (kaiserBeta) };
+    const auto tapCount { static_cast<size_t> (_tapCount) };
+    _coefficients.resize ((phaseCount + 1) * tapCount);
+    for (auto phase { 0 }; phase <= phaseCount; ++phase)
+    {
+        // tap j is applied to the source sample at (floor (position) - halfTapCount + 1 + j),
+        // and phase denotes the fractional part of the position
+        const auto fraction { static_cast<double> (phase) / phaseCount };
+        const auto phaseCoefficients { _coefficients.data () + static_cast<size_t> (phase) * tapCount };
+        double sum { 0.0 };
+        for (auto j { 0 }; j < _tapCount; ++j)
+        {
+            const auto t { static_cast<double> (j - halfTapCount + 1) - fraction };
+            const auto x { pi * cutoff * t };
+            const auto sinc { (std::abs (x) < 1.0e-9) ? 1.0 : std::sin (x) / x };
+            const auto relativePosition { t / halfTapCount };
+            const auto window { (std::abs (relativePosition) < 1.0) ? besselI0 (kaiserBeta * std::sqrt (1.0 - relativePosition * relativePosition)) / windowNormalization : 0.0 };
+            const auto coefficient { cutoff * sinc * window };
+            phaseCoefficients[j] = static_cast<float> (coefficient);
+            sum += coefficient;
+        }
+
+        // normalize each phase to unity gain at DC to avoid any ripple caused by the tabulation
+        for (size_t j { 0 }; j < tapCount; ++j)
+            phaseCoefficients[j] = static_cast<float> (phaseCoefficients[j] / sum);
+    }
+
+    _coefficientDeltas.resize (phaseCount * tapCount);
+    for (size_t i { 0 }; i < _coefficientDeltas.size (); ++i)
+        _coefficientDeltas[i] = _coefficients[i + tapCount] - _coefficients[i];
+}
+
+const TestResampler& TestResampler::getSharedResampler (double sourceSampleRate, double targetSampleRate, int kernelHalfWidth)
+{
+    static std::mutex resamplersMutex;
+    static std::map<std::tuple<double, double, int>, std::unique_ptr<const TestResampler>> resamplers;
+
+    std::lock_guard<std::mutex> lock { resamplersMutex };
+    auto& resampler { resamplers[std::make_tuple (sourceSampleRate, targetSampleRate, kernelHalfWidth)] };
+    if (!resampler)
+        resampler.reset (new TestResampler { sourceSampleRate, targetSampleRate, kernelHalfWidth });
+    return *resampler;
+}
+
+/*******************************************************************************/
+
+// Inner loop of the filter kernel: calculates both sum (samples[j] * coefficients[j]) and
+// sum (samples[j] * deltas[j]) in a single pass over the samples. count must be a multiple of 4.
+static void dotProducts (const float* samples, const float* coefficients, const float* deltas, const size_t count,
+                         float& coefficientsSum, float& deltasSum) noexcept
+{
+    size_t j { 0 };
+#if ARA_TEST_RESAMPLER_USE_SSE2
+    __m128 sumC { _mm_setzero_ps () };
+    __m128 sumD { _mm_setzero_ps () };
+    for (; j < count; j += 4)
+    {
+        const __m128 values { _mm_loadu_ps (samples + j) };
+        sumC = _mm_add_ps (sumC, _mm_mul_ps (values, _mm_loadu_ps (coefficients + j)));
+        sumD = _mm_add_ps (sumD, _mm_mul_ps (values, _mm_loadu_ps (deltas + j)));
+    }
+    alignas (16) float lanes[4];
+    _mm_store_ps (lanes, sumC);
+    coefficientsSum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    _mm_store_ps (lanes, sumD);
+    deltasSum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif ARA_TEST_RESAMPLER_USE_NEON
+    float32x4_t sumC { vdupq_n_f32 (0.0f) };
+    float32x4_t sumD { vdupq_n_f32 (0.0f) };
+    for (; j < count; j += 4)
+    {
+        const float32x4_t values { vld1q_f32 (samples + j) };
+        sumC = vmlaq_f32 (sumC, values, vld1q_f32 (coefficients + j));
+        sumD = vmlaq_f32 (sumD, values, vld1q_f32 (deltas + j));
+    }
+    float lanes[4];
+    vst1q_f32 (lanes, sumC);
+    coefficientsSum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    vst1q_f32 (lanes, sumD);
+    deltasSum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#else
+    coefficientsSum = 0.0f;
+    deltasSum = 0.0f;
+    for (; j < count; ++j)
+    {
+        coefficientsSum += samples[j] * coefficients[j];
+        deltasSum += samples[j] * deltas[j];
+    }
+#endif
+}
+
+// double precision samples are accumulated in double precision, without SIMD optimization
+static void dotProducts (const double* samples, const float* coefficients, const float* deltas, const size_t count,
+                         double& coefficientsSum, double& deltasSum) noexcept
+{
+    coefficientsSum = 0.0;
+    deltasSum = 0.0;
+    for (size_t j { 0 }; j < count; ++j)
+    {
+        coefficientsSum += samples[j] * coefficients[j];
+        deltasSum += samples[j] * deltas[j];
+    }
+}
+
+template <typename SampleType>
+SampleType TestResampler::interpolate (const SampleType* source, int64_t sourceSampleCount, double sourcePosition) const noexcept
+{
+    const auto integerPosition { std::floor (sourcePosition) };
+    const auto phasePosition { (sourcePosition - integerPosition) * phaseCount };
+    const auto phase { std::min (static_cast<int> (phasePosition), phaseCount - 1) };
+    const auto phaseFraction { static_cast<SampleType> (phasePosition - phase) };
+
+    const auto tapCount { static_cast<size_t> (_tapCount) };
+    const auto coefficients { _coefficients.data () + static_cast<size_t> (phase) * tapCount };
+    const auto deltas { _coefficientDeltas.data () + static_cast<size_t> (phase) * tapCount };
+    const auto firstTap { static_cast<int64_t> (integerPosition) - _tapCount / 2 + 1 };
+
+    // fast path if all taps are located inside the source
+    if ((firstTap >= 0) && (firstTap + _tapCount <= sourceSampleCount))
+    {
+        SampleType coefficientsSum, deltasSum;
+        dotProducts (source + firstTap, coefficients, deltas, tapCount, coefficientsSum, deltasSum);
+        return coefficientsSum + phaseFraction * deltasSum;
+    }
+
+    // otherwise skip the taps outside of the source
+    if ((firstTap + _tapCount <= 0) || (sourceSampleCount <= firstTap))
+        return SampleType { 0 };
+    const auto skippedStart { static_cast<size_t> (std::max<int64_t> (0, -firstTap)) };
+    const auto skippedEnd { static_cast<size_t> (std::max<int64_t> (0, firstTap + _tapCount - sourceSampleCount)) };
+    SampleType result { 0 };
+    for (auto j { skippedStart }; j < tapCount - skippedEnd; ++j)
+        result += source[firstTap + static_cast<int64_t> (j)] * (coefficients[j] + phaseFraction * deltas[j]);
+    return result;
+}
+
+template float TestResampler::interpolate<float> (const float* source, int64_t sourceSampleCount, double sourcePosition) const noexcept;
+template double TestResampler::interpolate<double> (const double* source, int64_t sourceSampleCount, double sourcePosition) const noexcept;
@@ -0,0 +1,70 @@
+//------------------------------------------------------------------------------
+//! \file       TestResampler.h
+//!             polyphase windowed-sinc sample rate converter for the ARA test plug-in renderer
+//! \project    ARA SDK Examples
+//! \copyright  Copyright (c) 2018-2025, Celemony Software GmbH, All Rights Reserved.
+//! \license    Licensed under the Apache License, Version 2.0 (the "License");
+//!             you may not use this file except in compliance with the License.
+//!             You may obtain a copy of the License at
+//!
+//!               http://www.apache.org/licenses/LICENSE-2.0
+//!
+//!             Unless required by applicable law or agreed to in writing, software
+//!             distributed under the License is distributed on an "AS IS" BASIS,
+//!             WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//!             See the License for the specific language governing permissions and
+//!             limitations under the License.
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Band-limited interpolation of a sampled signal at arbitrary fractional positions, using a
+// Kaiser-windowed sinc kernel. The kernel is tabulated for phaseCount fractional offsets, values
+// in between are linearly interpolated from the two adjacent phases.
+// When converting to a lower sample rate, the kernel cutoff is lowered and its length extended
+// accordingly, so that frequencies above the target Nyquist frequency are suppressed.
+// Like TestFFT, a TestResampler object is a "plan": the table is calculated once upon construction
+// and is immutable afterwards, so it can be shared between renderers and used on any thread.
+// Since the test plug-in caches all samples of an audio source in memory, the resampler does not
+// need to maintain any filter history - each output sample is calculated directly from the source.
+class TestResampler
+{
+public:
+    // number of tabulated kernel phases per source sample
+    static constexpr int phaseCount { 256 };
+
+    // kernelHalfWidth is the number of source samples on either side of the interpolated position
+    // that are taken into account when not converting to a lower sample rate - larger values
+    // provide a steeper low pass filter (and thus a wider pass band) at higher CPU cost.
+    TestResampler (double sourceSampleRate, double targetSampleRate, int kernelHalfWidth);
+
+    // returns a resampler for the given conversion, creating it upon first request - thread-safe,
+    // but may block and allocate, so it must not be called on the render thread.
+    // the returned resampler remains valid until the program terminates.
+    static const TestResampler& getSharedResampler (double sourceSampleRate, double targetSampleRate, int kernelHalfWidth);
+
+    double getSourceSampleRate () const noexcept { return _sourceSampleRate; }
+    double getTargetSampleRate () const noexcept { return _targetSampleRate; }
+    int getKernelHalfWidth () const noexcept { return _kernelHalfWidth; }
+
+    // number of source samples taken into account for each interpolated sample
+    int getTapCount () const noexcept { return _tapCount; }
+
+    // returns the signal value at the given (fractional) position in source samples,
+    // treating all samples outside of [0, sourceSampleCount) as silence.
+    // only instantiated for float and double source samples.
+    template <typename SampleType>
+    SampleType interpolate (const SampleType* source, int64_t sourceSampleCount, double sourcePosition) const noexcept;
+
+private:
+    const double _sourceSampleRate;
+    const double _targetSampleRate;
+    const int _kernelHalfWidth;
+    int _tapCount { 0 };
+    std::vector<float> _coefficients;       // (phaseCount + 1) phases of _tapCount taps each
+    std::vector<float> _coefficientDeltas;  // difference to the following phase, used to interpolate phases
+};
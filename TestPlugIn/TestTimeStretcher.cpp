@@ -0,0 +1,207 @@
+//------------------------------------------------------------------------------
+//! \file       TestTimeStretcher.cpp
+//!             WSOLA time stretching for the ARA test plug-in renderer
+//! \project    ARA SDK Examples
+//! \copyright  Copyright (c) 2018-2025, Celemony Software GmbH, All Rights Reserved.
+//! \license    Licensed under the Apache License, Version 2.0 (the "License");
+//!             you may not use this file except in compliance with the License.
+//!             You may obtain a copy of the License at
+//!
+//!               http://www.apache.org/licenses/LICENSE-2.0
+//!
+//!             Unless required by applicable law or agreed to in writing, software
+//!             distributed under the License is distributed on an "AS IS" BASIS,
+//!             WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//!             See the License for the specific language governing permissions and
+//!             limitations under the License.
+//------------------------------------------------------------------------------
+
+#include "TestTimeStretcher.h"
+
+#include "ARA_Library/Debug/ARADebug.h"
+
+#include <algorithm>
+#include <cmath>
+
+// SIMD instruction sets used to optimize the similarity search and the overlap-add
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define ARA_TEST_TIME_STRETCHER_USE_SSE2 1
+    #include <emmintrin.h>
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__) || defined (_M_ARM64)
+    #define ARA_TEST_TIME_STRETCHER_USE_NEON 1
+    #include <arm_neon.h>
+#endif
+
+/*******************************************************************************/
+
+// Returns sum (a[i] * b[i]) - this is where most of the stretching time is spent.
+static float dotProduct (const float* a, const float* b, const size_t count) noexcept
+{
+    size_t i { 0 };
+    float result { 0.0f };
+#if ARA_TEST_TIME_STRETCHER_USE_SSE2 || ARA_TEST_TIME_STRETCHER_USE_NEON
+    const auto vectorizedCount { count - count % 4 };
+#endif
+#if ARA_TEST_TIME_STRETCHER_USE_SSE2
+    __m128 sum { _mm_setzero_ps () };
+    for (; i < vectorizedCount; i += 4)
+        sum = _mm_add_ps (sum, _mm_mul_ps (_mm_loadu_ps (a + i), _mm_loadu_ps (b + i)));
+    alignas (16) float lanes[4];
+    _mm_store_ps (lanes, sum);
+    result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif ARA_TEST_TIME_STRETCHER_USE_NEON
+    float32x4_t sum { vdupq_n_f32 (0.0f) };
+    for (; i < vectorizedCount; i += 4)
+        sum = vmlaq_f32 (sum, vld1q_f32 (a + i), vld1q_f32 (b + i));
+    float lanes[4];
+    vst1q_f32 (lanes, sum);
+    result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+    for (; i < count; ++i)
+        result += a[i] * b[i];
+    return result;
+}
+
+// Overlap-add: output[i] += window[i] * frame[i]
+static void addWindowed (float* output, const float* window, const float* frame, const size_t count) noexcept
+{
+    size_t i { 0 };
+#if ARA_TEST_TIME_STRETCHER_USE_SSE2 || ARA_TEST_TIME_STRETCHER_USE_NEON
+    const auto vectorizedCount { count - count % 4 };
+#endif
+#if ARA_TEST_TIME_STRETCHER_USE_SSE2
+    for (; i < vectorizedCount; i += 4)
+        _mm_storeu_ps (output + i, _mm_add_ps (_mm_loadu_ps (output + i), _mm_mul_ps (_mm_loadu_ps (window + i), _mm_loadu_ps (frame + i))));
+#elif ARA_TEST_TIME_STRETCHER_USE_NEON
+    for (; i < vectorizedCount; i += 4)
+        vst1q_f32 (output + i, vmlaq_f32 (vld1q_f32 (output + i), vld1q_f32 (window + i), vld1q_f32 (frame + i)));
+#endif
+    for (; i < count; ++i)
+        output[i] += window[i] * frame[i];
+}
+
+// integer division rounding towards negative infinity
+static int64_t floorDivide (int64_t numerator, int64_t denominator) noexcept
+{
+    const auto quotient { numerator / denominator };
+    return ((numerator % denominator != 0) && (numerator < 0)) ? quotient - 1 : quotient;
+}
+
+/*******************************************************************************/
+
+TestTimeStretcher::TestTimeStretcher (int channelCount, int64_t maxSampleCount)
+: _channelCount { channelCount },
+  _maxSampleCount { maxSampleCount },
+  _output (static_cast<size_t> (channelCount * maxSampleCount)),
+  _frame (frameSize),
+  _template (hopSize),
+  _searchRange (hopSize + 2 * maxSearchOffset)
+{
+    static_assert (hopSize + 2 * maxSearchOffset <= frameSize, "the frame buffer is also used to read the search range");
+
+    // periodic Hann window, so that the windows of overlapping frames add up to 1
+    const auto pi { 3.14159265358979323846 };
+    _window.reserve (frameSize);
+    for (auto i { 0 }; i < frameSize; ++i)
+        _window.push_back (static_cast<float> (0.5 - 0.5 * std::cos (2.0 * pi * i / frameSize)));
+}
+
+void TestTimeStretcher::render (const SourceReader& reader, double sourceStart, double stretchFactor, int64_t startInOutput, int64_t count) noexcept
+{
+    ARA_INTERNAL_ASSERT (count <= _maxSampleCount);
+
+    if ((sourceStart != _sourceStart) || (stretchFactor != _stretchFactor))
+    {
+        _sourceStart = sourceStart;
+        _stretchFactor = stretchFactor;
+        reset ();
+    }
+
+    for (auto c { 0 }; c < _channelCount; ++c)
+        std::fill_n (_output.data () + static_cast<size_t> (c * _maxSampleCount), count, 0.0f);
+
+    // frame k covers the output samples [k * hopSize, k * hopSize + frameSize), so each output sample
+    // is covered by exactly two frames whose windows add up to 1
+    const auto endInOutput { startInOutput + count };
+    const auto firstFrameIndex { floorDivide (startInOutput, hopSize) - 1 };
+    const auto lastFrameIndex { floorDivide (endInOutput - 1, hopSize) };
+    for (auto frameIndex { firstFrameIndex }; frameIndex <= lastFrameIndex; ++frameIndex)
+    {
+        const auto frameStartInOutput { frameIndex * hopSize };
+        const auto overlapStart { std::max (startInOutput, frameStartInOutput) };
+        const auto overlapEnd { std::min (endInOutput, frameStartInOutput + frameSize) };
+        if (overlapEnd <= overlapStart)
+            continue;
+
+        const auto frameStart { getFrameStart (reader, frameIndex) };
+        const auto offsetInFrame { overlapStart - frameStartInOutput };
+        const auto overlapCount { static_cast<size_t> (overlapEnd - overlapStart) };
+        for (auto c { 0 }; c < _channelCount; ++c)
+        {
+            reader.readSamples (c, frameStart + offsetInFrame, overlapEnd - overlapStart, _frame.data ());
+            const auto output { _output.data () + static_cast<size_t> (c * _maxSampleCount + overlapStart - startInOutput) };
+            addWindowed (output, _window.data () + offsetInFrame, _frame.data (), overlapCount);
+        }
+    }
+}
+
+int64_t TestTimeStretcher::getNominalFrameStart (int64_t frameIndex) const noexcept
+{
+    // align the center of the frame with the stretched position of the center of its output range
+    const auto frameCenterInOutput { static_cast<double> (frameIndex * hopSize + frameSize / 2) };
+    return static_cast<int64_t> (std::floor (_sourceStart + frameCenterInOutput * _stretchFactor + 0.5)) - frameSize / 2;
+}
+
+int64_t TestTimeStretcher::getFrameStart (const SourceReader& reader, int64_t frameIndex) noexcept
+{
+    if (_hasFrames && (frameIndex == _lastFrameIndex))
+        return _lastFrameStart;
+    if (_hasFrames && (frameIndex == _lastFrameIndex - 1))
+        return _previousFrameStart;
+
+    // if not continuing the previous frames, start over at the nominal position
+    if (!_hasFrames || (frameIndex != _lastFrameIndex + 1))
+    {
+        _hasFrames = true;
+        _lastFrameIndex = frameIndex;
+        _lastFrameStart = getNominalFrameStart (frameIndex);
+        _previousFrameStart = getNominalFrameStart (frameIndex - 1);
+        return _lastFrameStart;
+    }
+
+    // the first half of the new frame overlaps with the second half of the previous frame,
+    // so search the candidate around the nominal position whose first half best matches it
+    const auto nominalFrameStart { getNominalFrameStart (frameIndex) };
+    readMonoSamples (reader, _lastFrameStart + hopSize, hopSize, _template.data ());
+    readMonoSamples (reader, nominalFrameStart - maxSearchOffset, hopSize + 2 * maxSearchOffset, _searchRange.data ());
+
+    auto bestOffset { 0 };
+    auto bestCorrelation { dotProduct (_template.data (), _searchRange.data () + maxSearchOffset, hopSize) };
+    for (auto offset { -maxSearchOffset }; offset <= maxSearchOffset; ++offset)
+    {
+        const auto correlation { dotProduct (_template.data (), _searchRange.data () + maxSearchOffset + offset, hopSize) };
+        if (correlation > bestCorrelation)
+        {
+            bestCorrelation = correlation;
+            bestOffset = offset;
+        }
+    }
+
+    _previousFrameStart = _lastFrameStart;
+    _lastFrameStart = nominalFrameStart + bestOffset;
+    _lastFrameIndex = frameIndex;
+    return _lastFrameStart;
+}
+
+void TestTimeStretcher::readMonoSamples (const SourceReader& reader, int64_t position, int64_t count, float samples[]) noexcept
+{
+    // the similarity search only needs a rough representation of the signal, so the channels are just summed up
+    ARA_INTERNAL_ASSERT (count <= frameSize);
+    reader.readSamples (0, position, count, samples);
+    for (auto c { 1 }; c < _channelCount; ++c)
+    {
+        reader.readSamples (c, position, count, _frame.data ());
+        for (int64_t i { 0 }; i < count; ++i)
+            samples[i] += _frame[static_cast<size_t> (i)];
+    }
+}
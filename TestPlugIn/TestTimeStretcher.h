@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------------
+//! \file       TestTimeStretcher.h
+//!             WSOLA time stretching for the ARA test plug-in renderer
+//! \project    ARA SDK Examples
+//! \copyright  Copyright (c) 2018-2025, Celemony Software GmbH, All Rights Reserved.
+//! \license    Licensed under the Apache License, Version 2.0 (the "License");
+//!             you may not use this file except in compliance with the License.
+//!             You may obtain a copy of the License at
+//!
+//!               http://www.apache.org/licenses/LICENSE-2.0
+//!
+//!             Unless required by applicable law or agreed to in writing, software
+//!             distributed under the License is distributed on an "AS IS" BASIS,
+//!             WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//!             See the License for the specific language governing permissions and
+//!             limitations under the License.
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Time stretching based on waveform similarity overlap-add (WSOLA, Verhelst & Roelands, 1993):
+// The output is composed of Hann-windowed frames with 50% overlap, placed at a fixed hop size.
+// Each frame is read from the source at its nominal stretched position, shifted by up to
+// maxSearchOffset samples so that it best matches (by cross-correlation) the natural continuation
+// of the previous frame, which avoids the phase jumps of plain overlap-add.
+// Since the offset of each frame depends on the previous frame, a TestTimeStretcher object stores
+// the state of a single stretched playback region. As long as rendering continues where the previous
+// call ended, this state is reused, upon seeking the frame offsets start from scratch.
+// All buffers are allocated upon construction, so rendering is realtime-safe, but not thread-safe.
+// Actual plug-ins will use more sophisticated algorithms, e.g. to preserve transients.
+class TestTimeStretcher
+{
+public:
+    static constexpr int frameSize { 1024 };
+    static constexpr int hopSize { frameSize / 2 };
+    static constexpr int maxSearchOffset { 256 };
+
+    // source samples are accessed through this interface - positions are in samples at the output
+    // sample rate, any sample rate conversion must be performed by the reader.
+    // samples outside of the available source range must be returned as silence.
+    class SourceReader
+    {
+    public:
+        virtual ~SourceReader () = default;
+        virtual void readSamples (int channel, int64_t position, int64_t count, float samples[]) const noexcept = 0;
+    };
+
+    // channelCount is the channel count of the source, maxSampleCount the maximum count per render () call
+    TestTimeStretcher (int channelCount, int64_t maxSampleCount);
+
+    int getChannelCount () const noexcept { return _channelCount; }
+    int64_t getMaxSampleCount () const noexcept { return _maxSampleCount; }
+
+    // renders count output samples starting at startInOutput, where output sample 0 corresponds to
+    // source position sourceStart and each following output sample advances stretchFactor source samples.
+    // the result can be accessed via getOutputChannel () until the next call to render ().
+    void render (const SourceReader& reader, double sourceStart, double stretchFactor, int64_t startInOutput, int64_t count) noexcept;
+    const float* getOutputChannel (int channel) const noexcept { return _output.data () + static_cast<size_t> (channel * _maxSampleCount); }
+
+    // discard the frame offset history, e.g. when the source has changed
+    void reset () noexcept { _hasFrames = false; }
+
+private:
+    int64_t getNominalFrameStart (int64_t frameIndex) const noexcept;
+    int64_t getFrameStart (const SourceReader& reader, int64_t frameIndex) noexcept;
+    void readMonoSamples (const SourceReader& reader, int64_t position, int64_t count, float samples[]) noexcept;
+
+private:
+    const int _channelCount;
+    const int64_t _maxSampleCount;
+    std::vector<float> _window;
+    std::vector<float> _output;         // _channelCount blocks of _maxSampleCount samples
+    std::vector<float> _frame;          // frameSize samples of a single channel
+    std::vector<float> _template;       // natural continuation of the previous frame, mixed down to mono
+    std::vector<float> _searchRange;    // candidate samples for the current frame, mixed down to mono
+
+    // source position and frame offset history
+    double _sourceStart { 0.0 };
+    double _stretchFactor { 1.0 };
+    bool _hasFrames { false };
+    int64_t _lastFrameIndex { 0 };
+    int64_t _lastFrameStart { 0 };
+    int64_t _previousFrameStart { 0 };
+};
@@ -120,18 +120,27 @@ tresult PLUGIN_API TestVST3Processor::process (Vst::ProcessData& data)
     ARA_VALIDATE_API_CONDITION (data.outputs[0].numChannels == getAudioBusChannelCount (audioOutputs[0]));
     ARA_VALIDATE_API_CONDITION (data.numSamples <= processSetup.maxSamplesPerBlock);
 
+    const auto use64BitSamples { data.symbolicSampleSize == Vst::kSample64 };
     if (auto playbackRenderer = _araPlugInExtension.getPlaybackRenderer<ARATestPlaybackRenderer> ())
     {
         // if we're an ARA playback renderer, calculate ARA playback output
-        playbackRenderer->renderPlaybackRegions (data.outputs[0].channelBuffers32, data.processContext->projectTimeSamples,
-                                                 data.numSamples, (data.processContext->state & Vst::ProcessContext::kPlaying) != 0);
+        const auto isPlaying { (data.processContext->state & Vst::ProcessContext::kPlaying) != 0 };
+        if (use64BitSamples)
+            playbackRenderer->renderPlaybackRegions (data.outputs[0].channelBuffers64, data.processContext->projectTimeSamples, data.numSamples, isPlaying);
+        else
+            playbackRenderer->renderPlaybackRegions (data.outputs[0].channelBuffers32, data.processContext->projectTimeSamples, data.numSamples, isPlaying);
     }
     else
     {
         // if we're no ARA playback renderer, we're just copying the inputs to the outputs, which is
         // appropriate both when being only an ARA editor renderer, or when being used in non-ARA mode.
         for (int32 c = 0; c < data.outputs[0].numChannels; ++c)
-            std::memcpy (data.outputs[0].channelBuffers32[c], data.inputs[0].channelBuffers32[c], sizeof (float) * static_cast<size_t> (data.numSamples));
+        {
+            if (use64BitSamples)
+                std::memcpy (data.outputs[0].channelBuffers64[c], data.inputs[0].channelBuffers64[c], sizeof (double) * static_cast<size_t> (data.numSamples));
+            else
+                std::memcpy (data.outputs[0].channelBuffers32[c], data.inputs[0].channelBuffers32[c], sizeof (float) * static_cast<size_t> (data.numSamples));
+        }
     }
 
     // if we are an ARA editor renderer, we now would add out preview signal to the output, but
@@ -152,14 +161,10 @@ tresult PLUGIN_API TestVST3Processor::setupProcessing (Vst::ProcessSetup& newSet
 //------------------------------------------------------------------------
 tresult PLUGIN_API TestVST3Processor::canProcessSampleSize (int32 symbolicSampleSize)
 {
-    // by default kSample32 is supported
-    if (symbolicSampleSize == Vst::kSample32)
+    // our renderer supports both single and double precision
+    if ((symbolicSampleSize == Vst::kSample32) || (symbolicSampleSize == Vst::kSample64))
         return kResultTrue;
 
-    // disable the following comment if your processing support kSample64
-    /* if (symbolicSampleSize == Vst::kSample64)
-        return kResultTrue; */
-
     return kResultFalse;
 }
 